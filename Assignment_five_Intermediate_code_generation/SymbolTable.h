@@ -1,36 +1,643 @@
 #include<bits/stdc++.h>
+#ifndef _WIN32
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+#endif
 using namespace std;
+
+// Operation counters, compiled in only with -DSYMTAB_STATS (STAT(...) is
+// empty otherwise). Written as JSON to $SYMTAB_STATS_FILE, default
+// symtab_stats.json, when the program exits.
+#ifdef SYMTAB_STATS
+struct TableStats{
+	static const int BUCKETS=33;	// chain entries examined: 0..31, then 32+
+	long long inserts=0, lookups=0, deletes=0, declares=0;
+	long long comparisons=0, preludeComparisons=0, scopePops=0, maxChain=0;
+	long long chainHistogram[BUCKETS]={};
+
+	void examined(long long n){ chainHistogram[min(n,(long long)BUCKETS-1)]++; }
+	~TableStats(){
+		const char *path=getenv("SYMTAB_STATS_FILE");
+		FILE *f=fopen(path ? path : "symtab_stats.json","w");
+		if(!f) return;
+		fprintf(f,"{\"table\": \"SymbolTable\", \"inserts\": %lld, \"lookups\": %lld, \"deletes\": %lld, "
+			"\"declares\": %lld, \"comparisons\": %lld, \"prelude_comparisons\": %lld, \"scope_pops\": %lld, "
+			"\"resizes\": 0, \"max_chain\": %lld, \"chain_histogram\": [",
+			inserts,lookups,deletes,declares,comparisons,preludeComparisons,scopePops,maxChain);
+		for(int i=0;i<BUCKETS;i++) fprintf(f,"%s%lld",i?", ":"",chainHistogram[i]);
+		fprintf(f,"]}\n");
+		fclose(f);
+	}
+};
+inline TableStats tableStats;	// one instance across lab5.l and lab5.y
+#define STAT(x) (tableStats.x)
+#else
+#define STAT(x) ((void)0)
+#endif
+
+// Interning service: each distinct spelling is stored once and named by a
+// 32-bit atom, so symbols compare by integer instead of by string.
+class AtomTable{
+	struct Entry{ unsigned int offset, length, hash; };
+	string pool;
+	vector<Entry> entries;
+	vector<unsigned int> index;	// atom+1, 0 = empty
+
+	static unsigned int hashText(string_view s){
+		unsigned int h=2166136261u;
+		for(unsigned char c: s) h=(h^c)*16777619u;
+		return h;
+	}
+	size_t probe(string_view s, unsigned int h){
+		size_t mask=index.size()-1, i=h&mask;
+		while(index[i]!=0){
+			Entry &e=entries[index[i]-1];
+			if(e.hash==h && e.length==s.size() && pool.compare(e.offset,e.length,s)==0) break;
+			i=(i+1)&mask;
+		}
+		return i;
+	}
+	void grow(){
+		index.assign(index.size()*2,0);
+		size_t mask=index.size()-1;
+		for(size_t a=0;a<entries.size();a++){
+			size_t i=entries[a].hash&mask;
+			while(index[i]!=0) i=(i+1)&mask;
+			index[i]=a+1;
+		}
+	}
+public:
+	static const unsigned int NONE=0xFFFFFFFFu;
+	AtomTable(): index(64,0){}
+
+	unsigned int find(string_view s){
+		size_t i=probe(s,hashText(s));
+		return index[i]==0 ? NONE : index[i]-1;
+	}
+	unsigned int intern(string_view s){
+		unsigned int h=hashText(s);
+		size_t i=probe(s,h);
+		if(index[i]!=0) return index[i]-1;
+		entries.push_back({(unsigned int)pool.size(),(unsigned int)s.size(),h});
+		pool.append(s.data(),s.size());
+		index[i]=entries.size();
+		if(entries.size()*2>index.size()) grow();
+		return entries.size()-1;
+	}
+	string text(unsigned int atom){ return string(view(atom)); }
+	// no copy; valid until the next intern()
+	string_view view(unsigned int atom){
+		if(atom==NONE) return string_view();
+		return string_view(pool).substr(entries[atom].offset,entries[atom].length);
+	}
+};
+extern AtomTable atoms;	// defined next to Tb in lab5.l
+
+// Per-compilation bump allocator. Symbol text for code fragments and
+// temporaries is carved out of 64 KiB blocks and never freed one by one;
+// release() drops every block at the end of the compilation. Anything
+// handed out stays put until then, so string_views into it are stable.
+class Arena{
+	vector<char*> blocks;
+	char *cur=NULL;
+	size_t left=0;
+	size_t used=0;
+	static const size_t BLOCK=64*1024;
+
+	char* newBlock(size_t size){
+		char *b=(char*)malloc(size);
+		if(!b) throw bad_alloc();
+		blocks.push_back(b);
+		return b;
+	}
+public:
+	Arena(){}
+	Arena(const Arena&)=delete;
+	Arena& operator=(const Arena&)=delete;
+	~Arena(){ release(); }
+
+	char* alloc(size_t n){
+		if(n>left){
+			if(n>BLOCK/4){	// big request: own block, keep filling the current one
+				used+=n;
+				return newBlock(n);
+			}
+			cur=newBlock(BLOCK);
+			left=BLOCK;
+		}
+		char *p=cur;
+		cur+=n; left-=n; used+=n;
+		return p;
+	}
+	string_view copy(string_view s){
+		char *p=alloc(s.size());
+		memcpy(p,s.data(),s.size());
+		return string_view(p,s.size());
+	}
+	// All parts laid out back to back as one string.
+	string_view concat(initializer_list<string_view> parts){
+		size_t n=0;
+		for(string_view s: parts) n+=s.size();
+		char *p=alloc(n), *q=p;
+		for(string_view s: parts){ memcpy(q,s.data(),s.size()); q+=s.size(); }
+		return string_view(p,n);
+	}
+	void release(){
+		for(char *b: blocks) free(b);
+		blocks.clear();
+		cur=NULL; left=0; used=0;
+	}
+	size_t bytesUsed(){ return used; }
+	size_t blockCount(){ return blocks.size(); }
+};
+extern Arena arena;	// defined next to Tb in lab5.l
+
+// Generated code as a list of arena fragments. Fragments that land right
+// after the previous one in the same block are merged, so a long program
+// is usually a handful of views rather than one string copied on every
+// append.
+class CodeBuffer{
+	vector<string_view> parts;
+	void push(string_view s){
+		if(!parts.empty() && parts.back().data()+parts.back().size()==s.data())
+			parts.back()=string_view(parts.back().data(),parts.back().size()+s.size());
+		else parts.push_back(s);
+	}
+public:
+	void add(string_view s){ push(arena.copy(s)); }
+	void add(initializer_list<string_view> s){ push(arena.concat(s)); }
+	void writeTo(ostream &out){
+		for(string_view s: parts) out.write(s.data(),s.size());
+	}
+};
+
+// Symbols that code generation works on, one column per attribute
+// instead of one object per symbol, so a pass over the whole table
+// (laying out storage, emitting .DATA) reads only the columns it needs.
+// Row i of every column describes the same symbol; rows are in the order
+// the symbols were first seen and are never removed.
+enum StorageType: unsigned char { NO_STORAGE, BYTE_STORAGE, WORD_STORAGE };
+
+class SymbolStore{
+	vector<int> rowOf;	// atom -> row+1, 0 = not stored
+public:
+	vector<unsigned int> name, kind;	// atoms
+	vector<StorageType> type;
+	vector<unsigned int> offset;	// in the data segment, set by layout()
+
+	static StorageType storageFor(string_view kind){
+		return kind=="NUMBER" ? NO_STORAGE : WORD_STORAGE;	// numbers are immediates
+	}
+	static int width(StorageType t){ return t==WORD_STORAGE ? 2 : t==BYTE_STORAGE ? 1 : 0; }
+	static const char* directive(StorageType t){ return t==BYTE_STORAGE ? " DB ?\n" : " DW ?\n"; }
+
+	// Row of sym, adding it if it is new.
+	int add(string_view sym, string_view k){
+		unsigned int atom=atoms.intern(sym);
+		if(atom>=rowOf.size()) rowOf.resize(atom+1,0);
+		if(rowOf[atom]) return rowOf[atom]-1;
+		name.push_back(atom);
+		kind.push_back(atoms.intern(k));
+		type.push_back(storageFor(k));
+		offset.push_back(0);
+		rowOf[atom]=name.size();
+		return name.size()-1;
+	}
+	int find(string_view sym){
+		unsigned int atom=atoms.find(sym);
+		return atom<rowOf.size() ? rowOf[atom]-1 : -1;
+	}
+	size_t size(){ return name.size(); }
+
+	// Assigns data segment offsets in row order; returns the segment size.
+	unsigned int layout(){
+		unsigned int at=0;
+		for(size_t i=0;i<type.size();i++){
+			offset[i]=at;
+			at+=width(type[i]);
+		}
+		return at;
+	}
+
+	// One declaration per symbol that needs storage, in row order.
+	void emitData(CodeBuffer &out){
+		for(size_t i=0;i<type.size();i++)
+			if(type[i]!=NO_STORAGE) out.add({atoms.view(name[i]),directive(type[i])});
+	}
+};
+
 class SymbolTable;
 class SymbolInfo
 {
-	string symbol, token_name;
+	unsigned int symbol, token_name;	// atoms
+	int scope;	// nesting level it was declared in, set by SymbolTable
 	friend class SymbolTable;
 public:
-	string code;
+	string_view code;	// points into the arena; SymbolInfo stays cheap to copy as YYSTYPE
 	SymbolInfo(){
-		 symbol="";
-		 token_name="";
-		 code="";
+		 symbol=AtomTable::NONE;
+		 token_name=AtomTable::NONE;
+		 scope=0;
 	 }
-	SymbolInfo(string n, string c){
-		 symbol=n;
-		 token_name=c;
-		 code="";
+	SymbolInfo(string_view n, string_view c){
+		 symbol=atoms.intern(n);
+		 token_name=atoms.intern(c);
+		 scope=0;
 	}
+	void setCode(string_view c){ code=arena.copy(c); }
 	void show(){
 		 cout<<"<";
-		 cout<<symbol<<" , "<<token_name;
+		 cout<<atoms.view(symbol)<<" , "<<atoms.view(token_name);
 		 cout<<">"<<endl;
 	}
-	string getSymbol(){ return symbol;}
-	string getToken(){return token_name;}
+	// views into the atom pool, valid until the next symbol is interned
+	string_view getSymbol(){ return atoms.view(symbol);}
+	string_view getToken(){return atoms.view(token_name);}
+};
+
+
+// Binary snapshot of a SymbolTable, written by SymbolTable::save() and
+// mapped back read-only by SymbolSnapshot. Everything is native-endian
+// uint32 so the mapped bytes are used in place:
+//
+//   SnapshotHeader
+//   uint32 bucketStart[buckets+1]   entries of bucket b are [start[b], start[b+1])
+//   SnapshotEntry  entries[count]   in bucket order, then column order
+//   char           pool[poolSize]   symbol and token spellings, back to back
+struct SnapshotHeader{
+	char magic[4];		// "SYMT"
+	uint32_t version;	// SNAPSHOT_VERSION
+	uint32_t buckets;	// must match the table's bucket count
+	uint32_t count;
+	uint32_t poolSize;
+};
+struct SnapshotEntry{ uint32_t symOff, symLen, tokOff, tokLen; };
+const uint32_t SNAPSHOT_VERSION=1;
+const int TABLE_BUCKETS=10;
+const size_t PARALLEL_PRINT_SYMBOLS=1<<16;	// print() uses a thread per this many symbols
+
+class SymbolSnapshot{
+	const char *base=NULL;
+	size_t len=0;
+	bool mapped=false;
+	string fallback;
+	const SnapshotHeader *head=NULL;
+	const uint32_t *start=NULL;
+	const SnapshotEntry *entries=NULL;
+	const char *pool=NULL;
+
+	void release(){
+#ifndef _WIN32
+		if(mapped) munmap((void*)base,len);
+#endif
+		base=NULL; len=0; mapped=false; head=NULL;
+		fallback.clear();
+	}
+	string_view text(uint32_t off, uint32_t n){
+		if((uint64_t)off+n>head->poolSize) return string_view();
+		return string_view(pool+off,n);
+	}
+public:
+	SymbolSnapshot(){}
+	SymbolSnapshot(const SymbolSnapshot&)=delete;
+	SymbolSnapshot& operator=(const SymbolSnapshot&)=delete;
+	~SymbolSnapshot(){ release(); }
+
+	// Maps path (or reads it, where it cannot be mapped) and checks the
+	// header and section sizes; nothing else is read.
+	bool open(const char *path){
+		release();
+#ifndef _WIN32
+		int fd=::open(path,O_RDONLY);
+		if(fd<0) return false;
+		struct stat st;
+		if(fstat(fd,&st)==0 && st.st_size>0){
+			void *p=mmap(NULL,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+			if(p!=MAP_FAILED){ base=(const char*)p; len=st.st_size; mapped=true; }
+		}
+		::close(fd);
+		if(!mapped)	// mmap refused (pipe, some network file systems): read it instead
+#endif
+		{
+			ifstream in(path,ios::binary);
+			if(!in) return false;
+			fallback.assign(istreambuf_iterator<char>(in),istreambuf_iterator<char>());
+			base=fallback.data(); len=fallback.size();
+		}
+		if(len<sizeof(SnapshotHeader)){ release(); return false; }
+		const SnapshotHeader *h=(const SnapshotHeader*)base;
+		uint64_t need=sizeof(SnapshotHeader)+4ull*(h->buckets+1ull)+(uint64_t)sizeof(SnapshotEntry)*h->count+h->poolSize;
+		if(memcmp(h->magic,"SYMT",4)!=0 || h->version!=SNAPSHOT_VERSION || h->buckets!=TABLE_BUCKETS || need>len){
+			release();
+			return false;
+		}
+		head=h;
+		start=(const uint32_t*)(base+sizeof(SnapshotHeader));
+		entries=(const SnapshotEntry*)(start+h->buckets+1);
+		pool=(const char*)(entries+h->count);
+		for(uint32_t b=0;b<h->buckets;b++){
+			if(start[b]>start[b+1] || start[b+1]>h->count){ release(); return false; }
+		}
+		return true;
+	}
+
+	bool isOpen(){ return head!=NULL; }
+	int bucketSize(int b){ return head ? start[b+1]-start[b] : 0; }
+	string_view symbol(int b, int col){ const SnapshotEntry &e=entries[start[b]+col]; return text(e.symOff,e.symLen); }
+	string_view token(int b, int col){ const SnapshotEntry &e=entries[start[b]+col]; return text(e.tokOff,e.tokLen); }
+
+	// Column of sym inside bucket b, or -1.
+	int find(int b, string_view sym){
+		for(int j=bucketSize(b)-1;j>=0;j--){
+			STAT(preludeComparisons++);
+			if(symbol(b,j)==sym) return j;
+		}
+		return -1;
+	}
+};
+
+// Persistent view of the table: a hash array mapped trie from atom to the
+// stack of its declarations, innermost first. Updates copy only the path
+// to the changed leaf (at most 7 nodes of up to 32 entries) and share the
+// rest, so a SymbolVersion is a root pointer that is O(1) to copy and
+// never changes once taken. The trie is keyed on a bijective mix of the
+// atom, so two atoms never share a full hash and no collision lists are
+// needed.
+struct Declaration{
+	unsigned int token;	// atom
+	int scope;
+	shared_ptr<const Declaration> outer;	// the declaration it shadows
+};
+
+class SymbolVersion{
+	struct Node{
+		struct Entry{
+			shared_ptr<const Node> child;	// subtrie, or else a leaf:
+			unsigned int atom;
+			shared_ptr<const Declaration> decl;
+		};
+		unsigned int bitmap=0;	// which of the 32 branches are present
+		vector<Entry> entries;	// one per set bit, in bit order
+	};
+	shared_ptr<const Node> root;
+	size_t count=0;	// declarations, shadowed ones included
+
+	static unsigned int mix(unsigned int x){
+		x^=x>>16; x*=0x7FEB352Du;
+		x^=x>>15; x*=0x846CA68Bu;
+		return x^(x>>16);
+	}
+
+	// Copy of node with atom bound to decl (removed if decl is null).
+	static shared_ptr<const Node> set(const shared_ptr<const Node> &node, int shift, unsigned int h,
+			unsigned int atom, const shared_ptr<const Declaration> &decl){
+		unsigned int bit=1u<<((h>>shift)&31);
+		if(!node){
+			if(!decl) return node;
+			auto n=make_shared<Node>();
+			n->bitmap=bit;
+			n->entries.push_back({NULL,atom,decl});
+			return n;
+		}
+		int pos=__builtin_popcount(node->bitmap&(bit-1));
+		if(!(node->bitmap&bit)){
+			if(!decl) return node;
+			auto n=make_shared<Node>(*node);
+			n->bitmap|=bit;
+			n->entries.insert(n->entries.begin()+pos,{NULL,atom,decl});
+			return n;
+		}
+		auto n=make_shared<Node>(*node);
+		Node::Entry &e=n->entries[pos];
+		if(e.child){
+			shared_ptr<const Node> c=set(e.child,shift+5,h,atom,decl);
+			if(c==e.child) return node;
+			if(c && (c->entries.size()>1 || c->entries[0].child)) e.child=c;
+			else if(c) e=c->entries[0];	// a lone leaf moves up
+			else e.child=NULL;
+		}
+		else if(e.atom==atom) e.decl=decl;
+		else{
+			if(!decl) return node;
+			shared_ptr<const Node> c=set(NULL,shift+5,mix(e.atom),e.atom,e.decl);
+			e={set(c,shift+5,h,atom,decl),0,NULL};
+		}
+		if(!e.child && !e.decl){
+			n->entries.erase(n->entries.begin()+pos);
+			n->bitmap&=~bit;
+		}
+		if(n->entries.empty()) return NULL;
+		return n;
+	}
+
+	template<class F>
+	static void walk(const Node *node, F &f){
+		if(!node) return;
+		for(const Node::Entry &e: node->entries){
+			if(e.child) walk(e.child.get(),f);
+			else f(e.atom,e.decl.get());
+		}
+	}
+	// The declaration stack of atom, or NULL if it has none.
+	const shared_ptr<const Declaration>* stackOf(unsigned int atom) const {
+		unsigned int h=mix(atom);
+		const Node *node=root.get();
+		for(int shift=0;node;shift+=5){
+			unsigned int bit=1u<<((h>>shift)&31);
+			if(!(node->bitmap&bit)) return NULL;
+			const Node::Entry &e=node->entries[__builtin_popcount(node->bitmap&(bit-1))];
+			if(!e.child) return e.atom==atom ? &e.decl : NULL;
+			node=e.child.get();
+		}
+		return NULL;
+	}
+public:
+	size_t size() const { return count; }
+
+	// Innermost declaration of the symbol in this version, or NULL.
+	const Declaration* find(unsigned int atom) const {
+		const shared_ptr<const Declaration> *d=stackOf(atom);
+		return d ? d->get() : NULL;
+	}
+	const Declaration* find(string_view sym) const {
+		unsigned int atom=atoms.find(sym);
+		return atom==AtomTable::NONE ? NULL : find(atom);
+	}
+
+	// New versions; this one is left untouched.
+	SymbolVersion push(unsigned int atom, unsigned int token, int scope) const {
+		const shared_ptr<const Declaration> *d=stackOf(atom);
+		SymbolVersion v;
+		v.root=set(root,0,mix(atom),atom,make_shared<Declaration>(Declaration{token,scope,d ? *d : NULL}));
+		v.count=count+1;
+		return v;
+	}
+	SymbolVersion pop(unsigned int atom) const {
+		const shared_ptr<const Declaration> *d=stackOf(atom);
+		if(!d) return *this;
+		SymbolVersion v;
+		v.root=set(root,0,mix(atom),atom,(*d)->outer);
+		v.count=count-1;
+		return v;
+	}
+
+	// Calls f(symbol, token, scope) for every visible (innermost) declaration.
+	template<class F>
+	void forEach(F f) const {
+		auto visit=[&](unsigned int atom, const Declaration *d){ f(atoms.view(atom),atoms.view(d->token),d->scope); };
+		walk(root.get(),visit);
+	}
 };
 
+// Minimal perfect hash over a fixed set of atoms (hash and displace):
+// keys are split into about n/3 groups, and each group, largest first,
+// gets the first seed that sends all its keys to still-free slots of
+// [0,n). A lookup is two mixes and one read of seed, and every key of the
+// set lands on its own slot; other atoms land on some slot too, so the
+// caller stores the atom there to check.
+class PerfectHash{
+	vector<unsigned int> seed;
+	size_t n=0;
+
+	static unsigned long long mix(unsigned long long z){
+		z+=0x9E3779B97F4A7C15ull;
+		z=(z^(z>>30))*0xBF58476D1CE4E5B9ull;
+		z=(z^(z>>27))*0x94D049BB133111EBull;
+		return z^(z>>31);
+	}
+	size_t groupOf(unsigned int key) const { return (mix(key)>>32)*seed.size()>>32; }
+	size_t slotOf(unsigned int key, unsigned int s) const {
+		return (mix(key^((unsigned long long)s<<32))&0xFFFFFFFFull)*n>>32;
+	}
+public:
+	static const unsigned int MAX_SEED=1u<<24;
 
+	size_t size() const { return n; }
+	size_t operator()(unsigned int key) const { return slotOf(key,seed[groupOf(key)]); }
+
+	// keys must be distinct; false (very unlikely) if some group found no seed.
+	bool build(const vector<unsigned int> &keys){
+		n=keys.size();
+		seed.assign(n/3+1,0);
+		vector<vector<unsigned int>> group(seed.size());
+		for(unsigned int k: keys) group[groupOf(k)].push_back(k);
+		vector<size_t> order(group.size());
+		iota(order.begin(),order.end(),0);
+		sort(order.begin(),order.end(),[&](size_t a, size_t b){ return group[a].size()>group[b].size(); });
+		vector<bool> used(n,false);
+		vector<size_t> slots;
+		for(size_t g: order){
+			if(group[g].empty()) break;
+			unsigned int s=1;
+			for(;s<MAX_SEED;s++){
+				slots.clear();
+				for(unsigned int k: group[g]){
+					size_t p=slotOf(k,s);
+					if(used[p] || find(slots.begin(),slots.end(),p)!=slots.end()) break;
+					slots.push_back(p);
+				}
+				if(slots.size()==group[g].size()) break;
+			}
+			if(s==MAX_SEED) return false;
+			for(size_t p: slots) used[p]=true;
+			seed[g]=s;
+		}
+		return true;
+	}
+	void clear(){ seed.clear(); seed.shrink_to_fit(); n=0; }
+};
+
+// Bloom filter over atoms, in front of the bucket walk. A miss is
+// answered without touching TABLE; a hit may be a false positive (about
+// 1% at 10 bits per atom) and still walks the bucket. Deleted and popped
+// symbols stay in it until the next rebuild, which only costs walks.
+class BloomFilter{
+	vector<unsigned long long> bits;	// power of two words
+	size_t count=0;
+
+	static unsigned long long mix(unsigned int atom){
+		unsigned long long z=atom+0x9E3779B97F4A7C15ull;
+		z=(z^(z>>30))*0xBF58476D1CE4E5B9ull;
+		z=(z^(z>>27))*0x94D049BB133111EBull;
+		return z^(z>>31);
+	}
+public:
+	static const int K=4, BITS_PER_KEY=10;
+
+	BloomFilter(): bits(16,0){}
+	void add(unsigned int atom){
+		unsigned long long h=mix(atom), mask=bits.size()*64-1, step=(h>>32)|1;
+		for(int i=0;i<K;i++,h+=step) bits[(h&mask)>>6]|=1ull<<(h&63);
+		count++;
+	}
+	bool mayContain(unsigned int atom){
+		unsigned long long h=mix(atom), mask=bits.size()*64-1, step=(h>>32)|1;
+		for(int i=0;i<K;i++,h+=step)
+			if(!(bits[(h&mask)>>6]&(1ull<<(h&63)))) return false;
+		return true;
+	}
+	bool full(){ return (count+1)*BITS_PER_KEY>bits.size()*64; }
+	void reset(size_t expected){
+		size_t words=16;
+		while(words*64<expected*BITS_PER_KEY) words*=2;
+		bits.assign(words,0);
+		count=0;
+	}
+};
+
+// Scopes: every symbol is tagged with the level it was inserted at, and
+// each insert appends its bucket to an undo log. Entries of the innermost
+// scope therefore always sit at the tail of their buckets, so exitScope()
+// just pops those tails for the buckets logged since the matching
+// enterScope(). Both are proportional to the symbols of that scope only.
+// Lookups scan buckets from the back, so an inner declaration shadows an
+// outer one with the same name.
 class SymbolTable{
-	vector<SymbolInfo>TABLE[10];
+	vector<SymbolInfo>TABLE[TABLE_BUCKETS];
+	SymbolSnapshot *prelude=NULL;	// read-only symbols that logically precede TABLE
+	int level=0;
+	vector<int> undo;		// bucket of every insert, in order
+	vector<size_t> scopeStart;	// undo.size() at each enterScope()
+	bool useBloom=false;
+	BloomFilter bloom;
+	bool versioned=false;	// current is kept in step only after the first snapshot()
+	SymbolVersion current;	// same symbols as TABLE, prelude excluded
+	struct FrozenSlot{ unsigned int atom; int col; };
+	bool frozen=false;		// LookUp goes through frozenIndex until the next change
+	PerfectHash frozenIndex;
+	vector<FrozenSlot> frozenSlots;
+
+	void rebuildBloom(){
+		size_t n=0;
+		for(int i=0;i<TABLE_BUCKETS;i++) n+=TABLE[i].size();
+		bloom.reset(2*n);	// room to grow before the next rebuild
+		for(int i=0;i<TABLE_BUCKETS;i++)
+			for(SymbolInfo &s: TABLE[i]) bloom.add(s.symbol);
+	}
+
+	int preludeSize(int index){ return prelude ? prelude->bucketSize(index) : 0; }
+
+	void add(string_view sym, string_view tk, int index){
+		thaw();
+		SymbolInfo obj(sym,tk);
+		obj.scope=level;
+		TABLE[index].push_back(obj);
+		if(versioned) current=current.push(obj.symbol,obj.token_name,level);
+		if(useBloom){
+			if(bloom.full()) rebuildBloom();
+			else bloom.add(obj.symbol);
+		}
+		STAT(maxChain=max(tableStats.maxChain,(long long)TABLE[index].size()));
+		undo.push_back(index);
+		int col_index=preludeSize(index)+TABLE[index].size()-1;
+		cout<<"Inserted at position "<<index<<", "<<col_index<<endl;
+	}
 public:
-	int hashfunction(string s){
+	SymbolStore store;	// every symbol INSERT/declare has seen, prelude ones too
+
+	int hashfunction(string_view s){
 		int len=s.size();
 		int sum=0;
 		for(int i=0;i<len;i++){
@@ -40,60 +647,242 @@ public:
 				sum=sum+d;
 			}
 		}
-		int mod=sum%10;
+		int mod=sum%TABLE_BUCKETS;
 		return mod;
 	}
 
-	void INSERT(string sym, string tk){
-		if(LookUp(sym)==-1){
-			int index=hashfunction(sym);
-			SymbolInfo obj(sym,tk);
-			TABLE[index].push_back(obj);
-			int col_index=TABLE[index].size()-1;
-			cout<<"Inserted at position "<<index<<", "<<col_index<<endl;
+	// The string_view API never copies the name; when it is already known
+	// (the common case for a lexer) no allocation happens at all.
+	void INSERT(string_view sym, string_view tk){
+		STAT(inserts++);
+		store.add(sym,tk);
+		int index=hashfunction(sym);
+		if(LookUp(sym,index)==-1){
+			add(sym,tk,index);
 		}
 		else{
 			cout<<sym<<" already exists in the Symbol Table"<<endl;
 		}
 	}
 
-	int LookUp(string sym){
+	// Like INSERT, but only a symbol of the current scope counts as a
+	// duplicate; one from an enclosing scope gets shadowed.
+	void declare(string_view sym, string_view tk){
+		STAT(declares++);
+		store.add(sym,tk);
+		int index=hashfunction(sym);
+		int col=LookUp(sym,index);
+		int base=preludeSize(index);
+		int scope= col<base ? 0 : TABLE[index][col-base].scope;	// prelude is global
+		if(col==-1 || scope<level){
+			add(sym,tk,index);
+		}
+		else{
+			cout<<sym<<" already exists in the Symbol Table"<<endl;
+		}
+	}
+
+	void enterScope(){
+		level++;
+		scopeStart.push_back(undo.size());
+	}
+
+	void exitScope(){
+		if(scopeStart.empty()) return;
+		thaw();
+		size_t start=scopeStart.back();
+		scopeStart.pop_back();
+		for(size_t k=undo.size();k>start;k--){
+			vector<SymbolInfo> &bucket=TABLE[undo[k-1]];
+			while(!bucket.empty() && bucket.back().scope==level){
+				if(versioned) current=current.pop(bucket.back().symbol);
+				bucket.pop_back();
+				STAT(scopePops++);
+			}
+		}
+		undo.resize(start);
+		level--;
+	}
+
+	int currentScope(){ return level; }
+
+	// For read-only phases: builds a minimal perfect hash over the symbols
+	// now in TABLE, so each LookUp is one probe instead of a bucket walk.
+	// Any insert, DELETE, exitScope() or attach() thaws the table again.
+	// Prelude symbols are still found through the snapshot.
+	bool freeze(){
+		vector<FrozenSlot> all;
+		for(int i=0;i<TABLE_BUCKETS;i++)
+			for(size_t j=0;j<TABLE[i].size();j++) all.push_back({TABLE[i][j].symbol,preludeSize(i)+(int)j});
+		// a shadowed symbol appears once per scope in one bucket; keep the innermost (last)
+		stable_sort(all.begin(),all.end(),[](const FrozenSlot &a, const FrozenSlot &b){ return a.atom<b.atom; });
+		vector<unsigned int> keys;
+		vector<FrozenSlot> last;
+		for(size_t k=0;k<all.size();k++)
+			if(k+1==all.size() || all[k+1].atom!=all[k].atom){ keys.push_back(all[k].atom); last.push_back(all[k]); }
+		if(!frozenIndex.build(keys)){ thaw(); return false; }
+		frozenSlots.assign(max<size_t>(keys.size(),1),FrozenSlot{AtomTable::NONE,-1});
+		for(const FrozenSlot &f: last) frozenSlots[frozenIndex(f.atom)]=f;
+		frozen=true;
+		return true;
+	}
+	void thaw(){
+		if(!frozen) return;
+		frozen=false;
+		frozenIndex.clear();
+		vector<FrozenSlot>().swap(frozenSlots);
+	}
+	bool isFrozen(){ return frozen; }
+
+	// The table as it is now, in O(1). Later changes to the table do not
+	// affect it, so one can be kept after each compilation stage.
+	// Versioning starts with the first call, which builds the trie from
+	// TABLE once; until then inserts and deletes do not touch it.
+	SymbolVersion snapshot(){
+		if(!versioned){
+			// buckets keep outer declarations before inner ones, so each
+			// atom's stack comes out innermost first
+			for(int i=0;i<TABLE_BUCKETS;i++)
+				for(SymbolInfo &e: TABLE[i]) current=current.push(e.symbol,e.token_name,e.scope);
+			versioned=true;
+		}
+		return current;
+	}
+
+	// Off by default; pays off once buckets hold more than a few symbols.
+	void enableBloom(bool on=true){
+		useBloom=on;
+		if(on) rebuildBloom();
+	}
+
+	int LookUp(string_view sym){ return LookUp(sym,hashfunction(sym)); }
+
+	// index must be hashfunction(sym); lets callers hash once per symbol.
+	int LookUp(string_view sym, int index){
 			int found=-1;
-			int index=hashfunction(sym);
+			STAT(lookups++);
+			unsigned int atom=atoms.find(sym);
+			if(atom==AtomTable::NONE){
+				STAT(examined(0));
+				return prelude ? prelude->find(index,sym) : found;
+			}
 
-			for(int j=0;j<TABLE[index].size();j++){
-				if(TABLE[index][j].symbol==sym){
-					found=j;
+			if(frozen){
+				STAT(comparisons++);
+				const FrozenSlot &f=frozenSlots[frozenIndex(atom)];
+				if(f.atom==atom) return f.col;
+				return prelude ? prelude->find(index,sym) : found;
+			}
+
+			if(useBloom && !bloom.mayContain(atom)){
+				STAT(examined(0));
+				return prelude ? prelude->find(index,sym) : found;
+			}
+
+			int j;
+			for(j=TABLE[index].size()-1;j>=0;j--){
+				STAT(comparisons++);
+				if(TABLE[index][j].symbol==atom){
+					found=preludeSize(index)+j;
 					break;
 				}
 			}
+			STAT(examined(TABLE[index].size()-max(j,0)));
+			if(found==-1 && prelude) found=prelude->find(index,sym);
 
 			return found;
 	}
 
-	int DELETE(string sym){
-			int found=-1;
+	// Returns -1 for unknown symbols and for prelude symbols, which are read-only.
+	int DELETE(string_view sym){
+			STAT(deletes++);
 			int index=hashfunction(sym);
-			int col=LookUp(sym);
-			auto it=TABLE[index].begin()+col;
+			int col=LookUp(sym,index);
+			int base=preludeSize(index);
+			if(col<base) return -1;
+			thaw();
+			auto it=TABLE[index].begin()+(col-base);
+			if(versioned) current=current.pop(it->symbol);	// it is the innermost declaration
 			TABLE[index].erase(it);
 			return col;
 	}
 
+	// Each bucket is formatted into its own string (on several threads once
+	// the table is large) and the strings are written in bucket order, one
+	// write each, so Table.txt comes out the same as with stf<<...<<endl.
 	void print(){
+		vector<string> lines(TABLE_BUCKETS);
+		auto format=[&](int i){
+			string &s=lines[i];
+			char num[12];
+			s.append(num,to_chars(num,num+sizeof num,i).ptr);
+			s+=" -> ";
+			auto entry=[&](string_view sym, string_view tk){
+				s+='<'; s+=sym; s+=" , "; s+=tk; s+="> ";
+			};
+			for(int j=0;j<preludeSize(i);j++) entry(prelude->symbol(i,j),prelude->token(i,j));
+			for(SymbolInfo &e: TABLE[i]) entry(atoms.view(e.symbol),atoms.view(e.token_name));
+			s+='\n';
+		};
+		size_t n=0;
+		for(int i=0;i<TABLE_BUCKETS;i++) n+=TABLE[i].size()+preludeSize(i);
+		size_t threads=min<size_t>({(size_t)thread::hardware_concurrency(),(size_t)TABLE_BUCKETS,n/PARALLEL_PRINT_SYMBOLS});
+		if(threads<2){
+			for(int i=0;i<TABLE_BUCKETS;i++) format(i);
+		}
+		else{
+			atomic<int> next(0);
+			vector<thread> workers;
+			for(size_t t=0;t<threads;t++)
+				workers.emplace_back([&](){ for(int i;(i=next++)<TABLE_BUCKETS;) format(i); });
+			for(thread &w: workers) w.join();
+		}
 		ofstream stf("Table.txt");
-		for(int i=0;i<10;i++)
-		{
-			 stf<<i<<" -> ";
-			 for(int j=0;j<TABLE[i].size();j++)
-			 {
-				 stf<<"<";
-				 stf<<TABLE[i][j].symbol<<" , "<<TABLE[i][j].token_name;
-				 stf<<"> ";
-			 }
-			 stf<<endl;
-		}
-		 return;
+		for(string &s: lines) stf.write(s.data(),s.size());
+	}
+
+	// Symbols of snap are visible to LookUp/INSERT without being copied;
+	// they come first in every bucket. snap must outlive the table.
+	void attach(SymbolSnapshot *snap){
+		thaw();	// frozen columns count the old prelude
+		prelude= snap && snap->isOpen() ? snap : NULL;
+	}
+
+	// Writes the prelude and every inserted symbol as a snapshot.
+	bool save(const char *path){
+		SnapshotHeader h;
+		memcpy(h.magic,"SYMT",4);
+		h.version=SNAPSHOT_VERSION;
+		h.buckets=TABLE_BUCKETS;
+		vector<uint32_t> start(1,0);
+		vector<SnapshotEntry> entries;
+		string pool;
+		auto put=[&](string_view sym, string_view tk){
+			SnapshotEntry e;
+			e.symOff=pool.size(); e.symLen=sym.size(); pool.append(sym.data(),sym.size());
+			e.tokOff=pool.size(); e.tokLen=tk.size(); pool.append(tk.data(),tk.size());
+			entries.push_back(e);
+		};
+		for(int i=0;i<TABLE_BUCKETS;i++){
+			for(int j=0;j<preludeSize(i);j++) put(prelude->symbol(i,j),prelude->token(i,j));
+			for(int j=0;j<TABLE[i].size();j++) put(atoms.view(TABLE[i][j].symbol),atoms.view(TABLE[i][j].token_name));
+			start.push_back(entries.size());
+		}
+		h.count=entries.size();
+		h.poolSize=pool.size();
+
+		// write to a temporary name first so a mapped prelude of the same path stays valid
+		string tmp=string(path)+".tmp";
+		FILE *f=fopen(tmp.c_str(),"wb");
+		if(!f) return false;
+		bool ok=fwrite(&h,sizeof h,1,f)==1
+			&& fwrite(start.data(),4,start.size(),f)==start.size()
+			&& fwrite(entries.data(),sizeof(SnapshotEntry),entries.size(),f)==entries.size()
+			&& fwrite(pool.data(),1,pool.size(),f)==pool.size();
+		ok=fclose(f)==0 && ok;
+		if(ok) ok=rename(tmp.c_str(),path)==0;
+		if(!ok) remove(tmp.c_str());
+		return ok;
 	}
 
 };
\ No newline at end of file
@@ -24,8 +24,9 @@ using namespace std;
 int yylex(void);                    // Function that gets tokens from lexer
 int t_count = 1;                    // Counter for temporary variables (t1, t2, t3...)
 char *str;                          // String to hold temporary variable names
-SymbolInfo asmc;                    // Object to store assembly code
+CodeBuffer asmc;                    // Assembly code, kept as fragments in the arena
 extern SymbolTable Tb;              // Symbol table from lexer (stores variables)
+SymbolSnapshot prelude;             // Symbols saved by an earlier run (memory-mapped)
 extern FILE *yyin;                  // Input file pointer
 
 // Output files for generated code
@@ -43,7 +44,7 @@ void yyerror(const char *s)
 // This is needed when we do operations like addition: a + b gets stored in t1
 char* newTemp(int i)
 {
-    char *tvar = (char*)malloc(15);  // Allocate memory for variable name
+    char *tvar = arena.alloc(15);    // Allocate memory for variable name (freed with the arena)
     sprintf(tvar, "t%d", i);         // Create name like "t1", "t2", etc.
     return tvar;
 }
@@ -103,8 +104,16 @@ char* newTemp(int i)
 program : MAIN LPARAN RPARAN LCURLY NEWLINE stmt RCURLY    
           { 
               // When we finish parsing the whole program, add ending to assembly code
-              asmc.code = asmc.code + "MAIN ENDP\nEND";  // End the main procedure
-              fasm << asmc.code;                          // Write all assembly code to file
+              asmc.add("MAIN ENDP\nEND");                // End the main procedure
+              
+              // Now every variable and temporary is known, so the data
+              // section can be generated from the symbol store
+              CodeBuffer head;
+              head.add(".MODEL SMALL\n.STACK 100H\n.DATA\n");
+              Tb.store.layout();                          // Give each variable its offset
+              Tb.store.emitData(head);                    // One "name DW ?" line per variable
+              head.writeTo(fasm);                         // Header and data section first,
+              asmc.writeTo(fasm);                         // then all the code
           }
 ;
 
@@ -137,7 +146,7 @@ expr_decl: term ASSOP expr SEMICOLON
                
                t_count -= 1;                              // Adjust temp variable counter
                str = newTemp(t_count);                    // Create temp variable name
-               SymbolInfo obj1(string(str), "");          // Create symbol object
+               SymbolInfo obj1(str, "");                  // Create symbol object
                $$ = obj1;                                 // Set result of this rule
                
                // Generate INTERMEDIATE CODE (human-readable)
@@ -147,7 +156,7 @@ expr_decl: term ASSOP expr SEMICOLON
                // Generate ASSEMBLY CODE (machine-level instructions)
                // MOV ax, <expression_result>  - Move expression result to AX register
                // MOV <variable>, ax           - Move AX register value to variable
-               asmc.code = asmc.code + "MOV ax, " + $3.getSymbol() + "\nMOV " + $1.getSymbol() + ", ax\n";
+               asmc.add({"MOV ax, ", $3.getSymbol(), "\nMOV ", $1.getSymbol(), ", ax\n"});
                
                t_count = 1;  // Reset counter for next statement      
            }
@@ -162,8 +171,9 @@ expr: expr ADD expr   // Pattern: <expression> + <expression>
           // Handle addition operation (like: 5 + 3 or a + b)
           
           str = newTemp(t_count);                        // Create new temp variable (t1, t2, etc.)
-          SymbolInfo obj1(string(str), "");              // Create symbol object for temp variable
+          SymbolInfo obj1(str, "");                      // Create symbol object for temp variable
           $$ = obj1;                                     // Set this rule's result to temp variable
+          Tb.store.add(str, "TEMP");                     // Temp needs a place in the data section
           
           // Generate INTERMEDIATE CODE
           // Example: if input is "5 + 3", this writes "t1 = 5 + 3" to code.ir file
@@ -174,7 +184,7 @@ expr: expr ADD expr   // Pattern: <expression> + <expression>
           // MOV bx, <second_operand>  - Move second number to BX register  
           // ADD ax, bx                - Add BX to AX (result in AX)
           // MOV <temp_var>, ax        - Store result in temporary variable
-          asmc.code = asmc.code + "MOV ax, " + $1.getSymbol() + "\nMOV bx, " + $3.getSymbol() + "\nADD ax, bx\nMOV " + $$.getSymbol() + ", ax\n";
+          asmc.add({"MOV ax, ", $1.getSymbol(), "\nMOV bx, ", $3.getSymbol(), "\nADD ax, bx\nMOV ", $$.getSymbol(), ", ax\n"});
           
           t_count++;  // Increment counter for next temporary variable
       }
@@ -202,6 +212,129 @@ term: IDENTIFIER
 
 %%
 
+/*
+ * BENCHMARK MODE - "lab5 --bench-mix [symbols] [operations] [insert%/lookup%/delete%]"
+ * 
+ * Drives the symbol table with a random mix of INSERT, LookUp and DELETE
+ * over 2*symbols names, half of them inserted first. It runs once with
+ * every name equally likely and once with Zipf(0.99) names (a few names
+ * are used very often, like "i" or "x" in real programs), and prints the
+ * throughput and the p50/p99/p999 latency of each operation. Each latency
+ * also includes one clock read (20-50 ns).
+ */
+void printLatencies(const char *op, vector<long long> &ns)
+{
+    if (ns.empty()) return;
+    sort(ns.begin(), ns.end());
+    auto at = [&](double q) { return ns[min(ns.size() - 1, (size_t)(q * ns.size()))]; };
+    printf("  %-7s n=%-9zu p50=%lld ns  p99=%lld ns  p999=%lld ns\n", op, ns.size(), at(0.5), at(0.99), at(0.999));
+}
+
+int benchMix(int symbols, int operations, int insertPct, int deletePct)
+{
+    // Distinct random names, shaped like identifiers
+    mt19937_64 rng(42);
+    set<string> seen;
+    vector<string> keys;
+    while ((int)keys.size() < 2 * symbols) {
+        string name(3 + rng() % 8, ' ');
+        for (char &c : name) c = 'a' + rng() % 26;
+        if (seen.insert(name).second) keys.push_back(name);
+    }
+
+    // Zipf ranks: P(rank r) is proportional to 1/(r+1)^0.99
+    vector<double> cdf(keys.size());
+    double sum = 0;
+    for (size_t r = 0; r < cdf.size(); r++) cdf[r] = sum += 1.0 / pow(r + 1.0, 0.99);
+    auto zipf = [&]() {
+        double u = uniform_real_distribution<double>(0, sum)(rng);
+        return min<size_t>(upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin(), cdf.size() - 1);
+    };
+
+    const char *opNames[3] = {"insert", "lookup", "delete"};
+    for (int dist = 0; dist < 2; dist++) {
+        SymbolTable table;
+        streambuf *console = cout.rdbuf(NULL);   // INSERT reports every insert; silence it
+        for (size_t i = 0; i < keys.size(); i += 2) table.INSERT(keys[i], "IDENTIFIER");
+
+        vector<pair<int, size_t>> ops(operations);  // (operation, key rank)
+        for (auto &op : ops) {
+            int roll = rng() % 100;
+            op.first = roll < insertPct ? 0 : roll < 100 - deletePct ? 1 : 2;
+            op.second = dist == 0 ? rng() % keys.size() : zipf();
+        }
+
+        vector<long long> latency[3];
+        auto start = chrono::steady_clock::now();
+        for (auto &op : ops) {
+            string_view name = keys[op.second];
+            auto t0 = chrono::steady_clock::now();
+            if (op.first == 0) table.INSERT(name, "IDENTIFIER");
+            else if (op.first == 1) table.LookUp(name);
+            else table.DELETE(name);
+            auto t1 = chrono::steady_clock::now();
+            latency[op.first].push_back(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count());
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout.rdbuf(console);
+        cout.clear();
+
+        printf("%s: %d symbols at start, %d operations in %.3f s (%.2f Mops/s)\n",
+               dist == 0 ? "uniform" : "zipf(0.99)", symbols, operations, seconds, operations / seconds / 1e6);
+        for (int op = 0; op < 3; op++) printLatencies(opNames[op], latency[op]);
+    }
+    return 0;
+}
+
+/*
+ * BENCHMARK MODE - "lab5 --bench-freeze [symbols] [lookups]"
+ * 
+ * Fills a table, then times the same LookUp calls (9 in 10 for symbols
+ * that are in the table) before and after Tb.freeze(), plus the freeze
+ * itself, and prints after how many lookups the freeze has paid for itself.
+ */
+int benchFreeze(int symbols, int lookups)
+{
+    mt19937_64 rng(7);
+    set<string> seen;
+    vector<string> names;
+    while ((int)names.size() < symbols) {
+        string name(3 + rng() % 8, ' ');
+        for (char &c : name) c = 'a' + rng() % 26;
+        if (seen.insert(name).second) names.push_back(name);
+    }
+    SymbolTable table;
+    table.enableBloom();                       // only to make filling the table quick
+    streambuf *console = cout.rdbuf(NULL);
+    for (string &name : names) table.INSERT(name, "IDENTIFIER");
+    cout.rdbuf(console);
+    cout.clear();
+
+    vector<string> queries(lookups);
+    for (string &q : queries) {
+        if (rng() % 10) q = names[rng() % names.size()];
+        else q = "missing_" + to_string(rng() % 1000), atoms.intern(q);
+    }
+
+    auto run = [&](vector<int> &result) {
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < queries.size(); i++) result[i] = table.LookUp(queries[i]);
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+    vector<int> before(lookups), after(lookups);
+    double walk = run(before);
+    auto start = chrono::steady_clock::now();
+    bool ok = table.freeze();
+    double build = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double probe = run(after);
+
+    printf("%d symbols, %d lookups, results %s\n", symbols, lookups, ok && before == after ? "identical" : "DIFFER");
+    printf("bucket walk: %.1f ns/lookup\n", 1e9 * walk / lookups);
+    printf("frozen:      %.1f ns/lookup (%.1fx)\n", 1e9 * probe / lookups, walk / probe);
+    printf("freeze():    %.3f ms, paid back after %.0f lookups\n", 1e3 * build, build / ((walk - probe) / lookups));
+    return ok && before == after ? 0 : 1;
+}
+
 /*
  * MAIN FUNCTION - This is where our compiler starts running
  * 
@@ -211,24 +344,56 @@ term: IDENTIFIER
  * 3. Start the parsing process
  * 4. Close files and print results
  */
-int main(void)
+int main(int argc, char *argv[])
 {
-    // STEP 1: Initialize assembly code with required header and data section
+    // Benchmark mode instead of compiling input.txt
+    if (argc > 1 && string(argv[1]) == "--bench-mix") {
+        int symbols = argc > 2 ? atoi(argv[2]) : 10000;
+        int operations = argc > 3 ? atoi(argv[3]) : 200000;
+        int insertPct = 10, lookupPct = 80, deletePct = 10;
+        if (argc > 4 && (sscanf(argv[4], "%d/%d/%d", &insertPct, &lookupPct, &deletePct) != 3
+                         || insertPct + lookupPct + deletePct != 100)) {
+            fprintf(stderr, "The mix must be three percentages adding up to 100, e.g. 10/80/10.\n");
+            return 1;
+        }
+        if (symbols < 1 || operations < 1) {
+            fprintf(stderr, "The benchmark needs at least one symbol and one operation.\n");
+            return 1;
+        }
+        return benchMix(symbols, operations, insertPct, deletePct);
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-freeze") {
+        int symbols = argc > 2 ? atoi(argv[2]) : 10000;
+        int lookups = argc > 3 ? atoi(argv[3]) : 1000000;
+        if (symbols < 1 || lookups < 1) {
+            fprintf(stderr, "The benchmark needs at least one symbol and one lookup.\n");
+            return 1;
+        }
+        return benchFreeze(symbols, lookups);
+    }
+
+    // STEP 1: Initialize assembly code with the start of the code section
     // This is like setting up the "skeleton" of our assembly program
+    // The header and data section are written in front of it once parsing
+    // is done (see the program rule):
     
     // .MODEL SMALL     - tells assembler this is a small program
     // .STACK 100H      - allocates 256 bytes for the stack  
     // .DATA            - start of data section (where variables are stored)
     // a DW ?           - declare variable 'a' as a word (16 bits), uninitialized
     // t1, t2, etc      - declare temporary variables for calculations
-    asmc.code = asmc.code + ".MODEL SMALL\n.STACK 100H\n.DATA\na DW ?\nt1 DW ?\nt2 DW ?\nt3 DW ?\nt4 DW ?\n";
     
     // .CODE            - start of code section (where instructions go)
     // MAIN PROC        - start of main procedure
     // MOV AX,@DATA     - load data segment address into AX register
     // MOV DS,AX        - set DS register to point to our data segment
-    asmc.code = asmc.code + ".CODE\nMAIN PROC\nMOV AX,@DATA\nMOV DS,AX \n";
+    asmc.add(".CODE\nMAIN PROC\nMOV AX,@DATA\nMOV DS,AX \n");
     
+    // Start from the symbols of a previous run if a snapshot is present.
+    // prelude.sym is simply a Table.sym from an earlier compilation.
+    if (prelude.open("prelude.sym"))
+        Tb.attach(&prelude);
+
     // STEP 2: Open input file and start parsing
     yyin = fopen("input.txt", "r");  // Open "input.txt" for reading our source code
     yyparse();                       // Start the parsing process (this calls our grammar rules)
@@ -237,9 +402,11 @@ int main(void)
     // STEP 3: Close output files
     fir.close();                     // Close intermediate representation file
     fasm.close();                    // Close assembly code file
+    arena.release();                 // Free all code fragments and temporaries at once
     
     // STEP 4: Print symbol table (shows all variables we found)
     Tb.print();                      // Display all identifiers and numbers we encountered
+    Tb.save("Table.sym");            // Binary snapshot, reusable as prelude.sym
     
     return 0;  // Program finished successfully
 }
\ No newline at end of file
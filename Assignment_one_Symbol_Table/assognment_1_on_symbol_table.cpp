@@ -1,26 +1,216 @@
 #include <bits/stdc++.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
+#ifdef COUNT_ALLOCATIONS
+// Counts every heap allocation; used by --alloc-check.
+static long long allocation_count = 0;
+void *operator new(size_t n)
+{
+    allocation_count++;
+    if(void *p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+#endif
+
 const string student_ID = "202314104";
-const int table_size = 20;
+const int table_size = 20; // initial capacity hint, rounded up to a power of two
+const size_t batch_size = 32; // keys resolved together by the *_Batch calls
+const size_t parallel_print_slots = 1 << 16; // Print() uses a thread per this many slots
+const size_t min_spill_symbols = 1 << 12; // --memory-budget spills no smaller hot tier, whatever the budget
 
-class Symbol_Info
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) ((void)0)
+#endif
+
+// Operation counters, compiled in only with -DSYMTAB_STATS. When off,
+// STAT(...) expands to nothing. The counters are written as JSON to
+// $SYMTAB_STATS_FILE (default symtab_stats.json) when the program exits.
+#ifdef SYMTAB_STATS
+struct Table_Stats
+{
+    static const int buckets = 33; // probe lengths 0..31, last one is 32+
+    long long inserts = 0, lookups = 0, deletes = 0;
+    long long probes = 0, comparisons = 0, resizes = 0, displacements = 0;
+    long long atom_probes = 0, string_comparisons = 0, atom_resizes = 0;
+    long long max_probe = 0;
+    long long probe_histogram[buckets] = {};
+
+    void probe_length(long long n)
+    {
+        probe_histogram[min(n, (long long)buckets - 1)]++;
+        max_probe = max(max_probe, n);
+    }
+
+    ~Table_Stats()
+    {
+        const char *path = getenv("SYMTAB_STATS_FILE");
+        FILE *f = fopen(path ? path : "symtab_stats.json", "w");
+        if(!f) return;
+        fprintf(f, "{\"table\": \"Symbol_Table\", \"inserts\": %lld, \"lookups\": %lld, \"deletes\": %lld, "
+                   "\"probes\": %lld, \"comparisons\": %lld, \"resizes\": %lld, \"displacements\": %lld, "
+                   "\"atom_probes\": %lld, \"string_comparisons\": %lld, \"atom_resizes\": %lld, "
+                   "\"max_probe\": %lld, \"probe_histogram\": [",
+                inserts, lookups, deletes, probes, comparisons, resizes, displacements,
+                atom_probes, string_comparisons, atom_resizes, max_probe);
+        for(int i = 0; i < buckets; i++) fprintf(f, "%s%lld", i ? ", " : "", probe_histogram[i]);
+        fprintf(f, "]}\n");
+        fclose(f);
+    }
+};
+static Table_Stats table_stats;
+#define STAT(x) (table_stats.x)
+#else
+#define STAT(x) ((void)0)
+#endif
+
+// Output is collected in one large buffer and handed to the OS a megabyte
+// at a time instead of flushing on every line.
+class Out_Buffer
 {
+    FILE *file;
+    string buf;
+    bool in_memory;
+
 public:
-    string symbol, symbol_Type;
-    Symbol_Info(string symbol, string symbol_Type)
+    // A NULL path gives a buffer that discards everything.
+    Out_Buffer(const char *path) : file(path ? fopen(path, "w") : NULL), in_memory(false) { buf.reserve(2 << 20); }
+    // No path at all keeps everything in memory, see text().
+    Out_Buffer() : file(NULL), in_memory(true) {}
+    ~Out_Buffer() { close(); }
+
+    bool ok() { return file != NULL; }
+    string_view text() { return buf; }
+
+    void flush()
     {
-        this->symbol = symbol;
-        this->symbol_Type = symbol_Type;
+        if(in_memory) return;
+        if(file && !buf.empty()) fwrite(buf.data(), 1, buf.size(), file);
+        buf.clear();
+    }
+
+    // Writes a large block straight to the file, after what is buffered.
+    void write(string_view block)
+    {
+        flush();
+        if(in_memory) buf += block;
+        else if(file) fwrite(block.data(), 1, block.size(), file);
+    }
+
+    void close()
+    {
+        flush();
+        if(file) fclose(file);
+        file = NULL;
+    }
+
+    Out_Buffer &operator<<(char c)
+    {
+        buf += c;
+        if(buf.size() >= (1 << 20)) flush();
+        return *this;
+    }
+
+    Out_Buffer &operator<<(const char *text)
+    {
+        buf += text;
+        if(buf.size() >= (1 << 20)) flush();
+        return *this;
+    }
+
+    Out_Buffer &operator<<(string_view text)
+    {
+        buf += text;
+        if(buf.size() >= (1 << 20)) flush();
+        return *this;
+    }
+
+    template<class T>
+    typename enable_if<is_integral<T>::value, Out_Buffer &>::type operator<<(T value)
+    {
+        char digits[24];
+        char *end = to_chars(digits, digits + sizeof digits, value).ptr;
+        buf.append(digits, end);
+        if(buf.size() >= (1 << 20)) flush();
+        return *this;
     }
 };
 
-class Symbol_Table
+// Read-only view of a whole input file: mapped into memory where mmap is
+// available, read in one go otherwise.
+class Mapped_File
 {
-    vector<Symbol_Info>table[table_size];
+    const char *ptr;
+    size_t len;
+    string fallback;
+    bool mapped;
+
 public:
+    Mapped_File(const char *path) : ptr(NULL), len(0), mapped(false)
+    {
+#ifndef _WIN32
+        int fd = open(path, O_RDONLY);
+        if(fd < 0) return;
+        struct stat st;
+        if(fstat(fd, &st) != 0) st.st_size = -1;
+        if(st.st_size == 0) ptr = "";
+        else if(st.st_size > 0)
+        {
+            void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(p != MAP_FAILED)
+            {
+                madvise(p, st.st_size, MADV_SEQUENTIAL);
+                ptr = (const char *)p;
+                len = st.st_size;
+                mapped = true;
+            }
+        }
+        ::close(fd);
+        if(ptr) return;
+#endif
+        ifstream in(path, ios::binary);
+        if(!in) return;
+        fallback.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        ptr = fallback.data();
+        len = fallback.size();
+    }
+
+    ~Mapped_File()
+    {
+#ifndef _WIN32
+        if(mapped) munmap((void *)ptr, len);
+#endif
+    }
 
-    int hashValue(string symbol)
+    bool ok() { return ptr != NULL; }
+    const char *data() { return ptr; }
+    size_t size() { return len; }
+};
+
+// Hash policies. Each one maps a spelling to 32 bits; the tables keep the
+// low bits as the home bucket. The first three are the functions the three
+// assignments started with, without their final "% modulus". Their low bits
+// are far too regular to mask (student_id is always a multiple of 16), so
+// --report spreads them over their own modulus, as chains, the way each
+// assignment used them, and the atom table never probes with them. Select
+// one per table with Symbol_Table<Policy>, or compare them all with --report.
+
+// Assignment one: first two and last two characters, shifted by the last
+// digit of the student ID and scaled by its digit sum.
+struct Student_ID_Hash
+{
+    static const char *name() { return "student_id"; }
+    static const unsigned int modulus = 20;
+    static unsigned int hash(string_view symbol)
     {
         int sum = 0;
         if(symbol.size() > 3)
@@ -37,116 +227,1577 @@ public:
 
         int last_digit = student_ID.back() - '0';
         sum<<=last_digit;
-        //cout << "Hashing successful\n";
-        return (sum*idSum)%table_size;
+        return sum*idSum;
+    }
+};
+
+// Lab five (SymbolTable::hashfunction): even-indexed characters times four.
+struct Even_Char_Hash
+{
+    static const char *name() { return "even_char"; }
+    static const unsigned int modulus = 10;
+    static unsigned int hash(string_view symbol)
+    {
+        int sum = 0;
+        for(int i=0; i<symbol.size(); i+=2) sum += symbol[i] << 2;
+        return sum;
+    }
+};
+
+// Tokenizer (SymbolTable::hashFunc): first three characters times two.
+struct First_Three_Hash
+{
+    static const char *name() { return "first_three"; }
+    static const unsigned int modulus = 12;
+    static unsigned int hash(string_view symbol)
+    {
+        int sum = 0;
+        for(int i=0; i<symbol.size() && i<3; i++) sum += symbol[i];
+        return sum * 2;
     }
+};
 
-    void Insert(string symbol, string type, ofstream &out)
+// FNV-1a over the whole spelling, seeded with the student ID. Default.
+struct FNV1a_Hash
+{
+    static const char *name() { return "fnv1a"; }
+    static const unsigned int modulus = 0; // none: every bit is usable
+    static unsigned int hash(string_view symbol)
     {
-        int hsh = hashValue(symbol);
+        unsigned int h = 2166136261u;
+        for(int i=0; i<student_ID.size(); i++) h = (h ^ student_ID[i]) * 16777619u;
+        for(int i=0; i<symbol.size(); i++) h = (h ^ (unsigned char)symbol[i]) * 16777619u;
+        return h;
+    }
+};
 
-        for(int i=0; i<table[hsh].size(); i++)
+// Eight bytes per step with 64-bit multiply/rotate mixing and a final
+// avalanche; faster than FNV-1a on long names and well spread in every bit.
+struct Word_Mix_Hash
+{
+    static const char *name() { return "word_mix"; }
+    static const unsigned int modulus = 0;
+    static unsigned int hash(string_view symbol)
+    {
+        const char *p = symbol.data();
+        size_t n = symbol.size();
+        unsigned long long h = 0x9E3779B97F4A7C15ull ^ n, k;
+        for(; n >= 8; p += 8, n -= 8)
         {
-            if(table[hsh][i].symbol == symbol)
-            {
-                out << "Symbol already exists.\n";
-                return;
-            }
+            memcpy(&k, p, 8);
+            h ^= k * 0xBF58476D1CE4E5B9ull;
+            h = ((h << 31) | (h >> 33)) * 0x94D049BB133111EBull;
+        }
+        if(n > 0)
+        {
+            k = 0;
+            memcpy(&k, p, n);
+            h ^= k * 0xBF58476D1CE4E5B9ull;
+            h = ((h << 31) | (h >> 33)) * 0x94D049BB133111EBull;
+        }
+        h ^= h >> 32;
+        h *= 0xD6E8FEB86659FD93ull;
+        h ^= h >> 32;
+        return (unsigned int)h;
+    }
+};
+
+// Interns every spelling the table sees and hands out a stable 32-bit atom
+// for it. Each distinct string is stored once in one character pool and
+// hashed once; afterwards symbols are compared by atom, not by text.
+// The stored hash is also what Symbol_Table uses, so both share a policy;
+// the index itself probes with FNV-1a when the policy is a legacy one.
+//
+// Each index slot also keeps the first inline_size bytes of its spelling,
+// zero padded, with the length (or long_tag) in the last byte. For the
+// short names that make up most sources a probe is then decided by the
+// hash and two 64-bit compares, without leaving the slot; only a match on
+// a longer name goes out to the pool.
+template<class Hash_Policy = FNV1a_Hash>
+class Atom_Table
+{
+    struct Atom_Entry
+    {
+        unsigned int offset, length, hash;
+    };
+
+    static const size_t inline_size = 15;
+    static const unsigned char long_tag = 0xFF;
+
+    struct Index_Slot
+    {
+        unsigned long long key[2]; // spelling prefix, then length or long_tag
+        unsigned int hash;
+        unsigned int atom;         // atom + 1, 0 marks an empty slot
+    };
+
+    // A spelling in the same form as Index_Slot::key.
+    struct Probe_Key
+    {
+        unsigned long long key[2] = {0, 0};
+        Probe_Key(string_view text)
+        {
+            unsigned char tag = text.size() <= inline_size ? text.size() : long_tag;
+            memcpy(key, text.data(), min(text.size(), inline_size));
+            memcpy((char *)key + inline_size, &tag, 1);
+        }
+    };
+
+    static bool is_long(const unsigned long long *key) { return ((const unsigned char *)key)[inline_size] == long_tag; }
+
+    string pool;
+    vector<Atom_Entry> entries;
+    vector<Index_Slot> index;
+
+    // Two wide compares; the pool is only read to confirm a long name.
+    bool same_key(const Index_Slot &slot, string_view text)
+    {
+        Probe_Key k(text);
+        if(slot.key[0] != k.key[0] || slot.key[1] != k.key[1]) return false;
+        if(!is_long(k.key)) return true;
+        STAT(string_comparisons++);
+        const Atom_Entry &e = entries[slot.atom - 1];
+        return pool.compare(e.offset, e.length, text) == 0;
+    }
+
+    // Hash the index probes with; hsh is Hash_Policy's hash of text.
+    static unsigned int index_hash(string_view text, unsigned int hsh)
+    {
+        return Hash_Policy::modulus ? FNV1a_Hash::hash(text) : hsh;
+    }
+
+    size_t probe(string_view text, unsigned int hsh)
+    {
+        hsh = index_hash(text, hsh);
+        size_t mask = index.size() - 1, i = hsh & mask;
+        while(index[i].atom != 0)
+        {
+            STAT(atom_probes++);
+            if(index[i].hash == hsh && same_key(index[i], text)) break;
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void grow()
+    {
+        STAT(atom_resizes++);
+        rehash(index.size() * 2);
+    }
+
+    void rehash(size_t cap)
+    {
+        vector<Index_Slot> old(cap, Index_Slot());
+        old.swap(index);
+        size_t mask = index.size() - 1;
+        for(const Index_Slot &slot : old)
+        {
+            if(slot.atom == 0) continue;
+            size_t i = slot.hash & mask;
+            while(index[i].atom != 0) i = (i + 1) & mask;
+            index[i] = slot;
+        }
+    }
+
+public:
+    static const unsigned int none = 0xFFFFFFFFu;
+
+    Atom_Table() : index(64, Index_Slot()) {}
+
+    unsigned int hashValue(string_view text) { return Hash_Policy::hash(text); }
+
+    // Atom for text, or none if it was never interned. Never allocates.
+    // hsh, when given, must be hashValue(text).
+    unsigned int find(string_view text) { return find(text, hashValue(text)); }
+    unsigned int find(string_view text, unsigned int hsh)
+    {
+        size_t i = probe(text, hsh);
+        return index[i].atom == 0 ? none : index[i].atom - 1;
+    }
+
+    // Only allocates the first time a spelling is seen.
+    unsigned int intern(string_view text) { return intern(text, hashValue(text)); }
+    unsigned int intern(string_view text, unsigned int hsh)
+    {
+        size_t i = probe(text, hsh);
+        if(index[i].atom != 0) return index[i].atom - 1;
+
+        Atom_Entry e;
+        e.offset = pool.size();
+        e.length = text.size();
+        e.hash = hsh;
+        pool += text;
+        entries.push_back(e);
+
+        Probe_Key k(text);
+        index[i].key[0] = k.key[0];
+        index[i].key[1] = k.key[1];
+        index[i].hash = index_hash(text, hsh);
+        index[i].atom = entries.size();
+        if(entries.size() * 2 > index.size()) grow();
+        return entries.size() - 1;
+    }
+
+    // Starts loading the index slots of a block of spellings and their hashes.
+    void prefetch(const string_view *texts, const unsigned int *hashes, size_t n)
+    {
+        size_t mask = index.size() - 1;
+        for(size_t k = 0; k < n; k++) PREFETCH(&index[index_hash(texts[k], hashes[k]) & mask]);
+    }
+
+    // find() for a block of spellings with precomputed hashes. The index
+    // slots of the whole block are prefetched first, then the entries of
+    // the long names, so the misses overlap. Short names need only the slot.
+    void find_batch(const string_view *texts, const unsigned int *hashes, size_t n, unsigned int *out)
+    {
+        size_t mask = index.size() - 1;
+        prefetch(texts, hashes, n);
+        for(size_t k = 0; k < n; k++)
+        {
+            const Index_Slot &slot = index[index_hash(texts[k], hashes[k]) & mask];
+            if(slot.atom != 0 && is_long(slot.key)) PREFETCH(&entries[slot.atom - 1]);
         }
+        for(size_t k = 0; k < n; k++) out[k] = find(texts[k], hashes[k]);
+    }
 
-        table[hsh].push_back(Symbol_Info(symbol, type));
-        out << "Symbol inserted at position " << hsh << ',' << (table[hsh].size() - 1) << endl;
+    unsigned int hashOf(unsigned int atom) { return entries[atom].hash; }
+    // Valid until the next intern().
+    string_view text(unsigned int atom) { return string_view(pool).substr(entries[atom].offset, entries[atom].length); }
+    size_t size() { return entries.size(); }
 
+    // Room for n atoms in all without growing the index.
+    void reserve(size_t n)
+    {
+        entries.reserve(n);
+        size_t cap = index.size();
+        while(cap < n * 2) cap <<= 1;
+        if(cap > index.size()) rehash(cap);
+    }
+    size_t bytes() { return pool.capacity() + entries.capacity() * sizeof(Atom_Entry) + index.capacity() * sizeof(Index_Slot); }
+};
+
+Atom_Table<> atoms;
+
+class Symbol_Info
+{
+public:
+    unsigned int symbol, symbol_Type; // atoms
+    Symbol_Info() : symbol(Atom_Table<>::none), symbol_Type(Atom_Table<>::none) {}
+    Symbol_Info(unsigned int symbol, unsigned int symbol_Type)
+    {
+        this->symbol = symbol;
+        this->symbol_Type = symbol_Type;
+    }
+};
+
+// HyperLogLog estimate of how many distinct strings were added, in 16 KiB
+// and one pass. Each string's 64-bit hash picks one of 2^precision
+// registers with its top bits; the register keeps the longest run of
+// leading zeros seen in the remaining bits. The standard error is
+// 1.04/sqrt(2^precision), about 0.8%.
+class Cardinality_Sketch
+{
+    static const int precision = 14;
+    vector<unsigned char> registers;
+
+    static unsigned long long hash64(string_view text)
+    {
+        unsigned long long h = 14695981039346656037ull;
+        for(unsigned char c : text) h = (h ^ c) * 1099511628211ull;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return h ^ (h >> 31);
+    }
+
+    static int leading_zeros(unsigned long long x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(x);
+#else
+        int n = 0;
+        while(!(x & (1ull << 63))) x <<= 1, n++;
+        return n;
+#endif
+    }
+
+public:
+    Cardinality_Sketch() : registers(1 << precision, 0) {}
+
+    void add(string_view text)
+    {
+        unsigned long long h = hash64(text);
+        size_t r = h >> (64 - precision);
+        unsigned long long rest = (h << precision) | (1ull << (precision - 1)); // never all zero
+        registers[r] = max(registers[r], (unsigned char)(leading_zeros(rest) + 1));
+    }
+
+    size_t estimate() const
+    {
+        double m = registers.size(), sum = 0;
+        size_t zeros = 0;
+        for(unsigned char reg : registers)
+        {
+            sum += ldexp(1.0, -reg);
+            zeros += reg == 0;
+        }
+        double e = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+        if(e <= 2.5 * m && zeros > 0) e = m * log(m / zeros); // small range: linear counting
+        return (size_t)(e + 0.5);
     }
+};
+
+// Flat open-addressing table using Robin Hood probing.
+// Every slot remembers how far it sits from its home bucket (dist, -1 when
+// empty). Insertion steals the slot of any entry that is closer to home than
+// the one being placed, which keeps probe sequences short and sorted by home,
+// so a lookup can stop as soon as it meets an entry closer to home than itself.
+// Deletion shifts the following run back by one slot, so no tombstones are
+// ever left behind. The table doubles once it is 7/8 full.
+// Spellings live in an Atom_Table with the same hash policy.
+template<class Hash_Policy = FNV1a_Hash>
+class Symbol_Table
+{
+    typedef Atom_Table<Hash_Policy> Atoms;
 
-    void Lookup(string symbol, ofstream &out)
+    struct Slot
     {
-        int hsh = hashValue(symbol);
+        Symbol_Info info;
+        unsigned int hash;
+        int dist;
+        Slot() : hash(0), dist(-1) {}
+    };
+
+    Atoms &atoms;
+    vector<Slot> slots;
+    size_t mask;
+    size_t count;
+
+    size_t home(unsigned int hsh) { return hsh & mask; }
 
-        for(int i=0; i<table[hsh].size(); i++)
+    // Returns the slot index of the symbol atom, or -1 if it is not in the table.
+    long long findSlot(unsigned int symbol, unsigned int hsh)
+    {
+        size_t i = home(hsh);
+        int d = 0;
+        for(; slots[i].dist >= d; d++)
         {
-            if(table[hsh][i].symbol == symbol)
+            STAT(probes++);
+            STAT(comparisons++);
+            if(slots[i].info.symbol == symbol)
             {
-                out << "Found symbol at " << hsh << ',' << i << endl;
-                return;
+                STAT(probe_length(d + 1));
+                return i;
             }
+            i = (i + 1) & mask;
         }
-        out << "Not found.\n";
+        STAT(probes++); // the slot that ended the search
+        STAT(probe_length(d + 1));
+        return -1;
     }
 
-    void Delete(string symbol, ofstream &out)
+    // Robin Hood placement; returns the slot the new entry ended up in.
+    size_t place(Slot entry)
     {
-        int hsh = hashValue(symbol);
-        for(int i=0; i<table[hsh].size(); i++)
+        size_t i = home(entry.hash), landed = slots.size();
+        entry.dist = 0;
+        while(true)
         {
-            if(table[hsh][i].symbol == symbol)
+            if(slots[i].dist < 0)
             {
-                table[hsh].erase(table[hsh].begin() + i);
-                out << "Deleted from " << hsh << ',' << i << endl;
-                return;
+                slots[i] = std::move(entry);
+                return landed == slots.size() ? i : landed;
             }
+            if(slots[i].dist < entry.dist)
+            {
+                STAT(displacements++);
+                swap(slots[i], entry);
+                if(landed == slots.size()) landed = i;
+            }
+            i = (i + 1) & mask;
+            entry.dist++;
+        }
+    }
+
+    void grow()
+    {
+        STAT(resizes++);
+        vector<Slot> old;
+        old.swap(slots);
+        slots.resize(old.size() * 2);
+        mask = slots.size() - 1;
+        for(size_t i = 0; i < old.size(); i++)
+        {
+            if(old[i].dist >= 0) place(std::move(old[i]));
+        }
+    }
+
+public:
+
+    Symbol_Table(Atoms &atoms, size_t capacity = table_size) : atoms(atoms), count(0)
+    {
+        size_t cap = 8;
+        while(cap < capacity) cap <<= 1;
+        slots.resize(cap);
+        mask = cap - 1;
+    }
+
+    // Sized for the distinct spellings sketch has seen plus 5% for its
+    // error, so filling the table with them resizes neither the table nor
+    // atoms.
+    Symbol_Table(Atoms &atoms, const Cardinality_Sketch &sketch)
+        : Symbol_Table(atoms, Capacity_For(sketch.estimate() * 21 / 20 + 16))
+    {
+        atoms.reserve(atoms.size() + sketch.estimate() * 21 / 20 + 16);
+    }
+
+    // Smallest capacity that holds symbols entries below the 7/8 load limit.
+    static size_t Capacity_For(size_t symbols) { return symbols * 8 / 7 + 1; }
+
+    size_t size() { return count; }
+    size_t capacity() { return slots.size(); }
+    size_t bytes() { return slots.capacity() * sizeof(Slot); }
+
+    // Symbol atom in slot i, as returned by Find.
+    unsigned int Symbol_At(long long i) { return slots[i].info.symbol; }
+
+    // Calls f(info, hash) for every stored symbol, in slot order.
+    template<class F>
+    void For_Each(F f)
+    {
+        for(size_t i = 0; i < slots.size(); i++)
+        {
+            if(slots[i].dist >= 0) f(slots[i].info, slots[i].hash);
+        }
+    }
+
+    // Callers that probe the same spelling repeatedly can hash it once and
+    // pass the result to the overloads taking hsh.
+    unsigned int hashValue(string_view symbol) { return atoms.hashValue(symbol); }
+
+    // Insert, Lookup and Delete never allocate when the symbol is already
+    // known; only a first-time spelling is copied into the atom table.
+    void Insert(string_view symbol, string_view type, Out_Buffer &out) { Insert(symbol, hashValue(symbol), type, out); }
+    void Insert(string_view symbol, unsigned int hsh, string_view type, Out_Buffer &out)
+    {
+        STAT(inserts++);
+        unsigned int atom = atoms.intern(symbol, hsh);
+
+        if(findSlot(atom, hsh) >= 0)
+        {
+            out << "Symbol already exists.\n";
+            return;
+        }
+
+        if((count + 1) * 8 > slots.size() * 7) grow();
+
+        Slot entry;
+        entry.info = Symbol_Info(atom, atoms.intern(type));
+        entry.hash = hsh;
+        size_t i = place(std::move(entry));
+        count++;
+        out << "Symbol inserted at position " << home(hsh) << ',' << slots[i].dist << '\n';
+
+    }
+
+    // Slot holding symbol, or -1; prints nothing.
+    long long Find(string_view symbol) { return Find(symbol, hashValue(symbol)); }
+    long long Find(string_view symbol, unsigned int hsh)
+    {
+        unsigned int atom = atoms.find(symbol, hsh);
+        return atom == Atoms::none ? -1 : findSlot(atom, hsh);
+    }
+
+    void Lookup(string_view symbol, Out_Buffer &out) { Lookup(symbol, hashValue(symbol), out); }
+    void Lookup(string_view symbol, unsigned int hsh, Out_Buffer &out)
+    {
+        STAT(lookups++);
+        Print_Lookup(Find(symbol, hsh), out);
+    }
+
+    void Print_Lookup(long long i, Out_Buffer &out)
+    {
+        if(i >= 0)
+        {
+            out << "Found symbol at " << home(slots[i].hash) << ',' << slots[i].dist << '\n';
+            return;
         }
         out << "Not found.\n";
     }
 
-    void Print(ofstream &out)
+    // Batched versions of Find, Lookup and Insert. A block of up to
+    // batch_size keys is hashed up front and the atom-table and slot cache
+    // lines of all of them are prefetched before any key is resolved, so
+    // their misses overlap instead of forming one dependent chain per key.
+    // Keys are still resolved in order, so results and output are exactly
+    // those of the one-at-a-time calls.
+    void Find_Batch(const string_view *symbols, size_t n, long long *slot)
     {
-        for(int i=0; i<table_size; i++)
+        unsigned int hashes[batch_size], found[batch_size];
+        for(size_t b = 0; b < n; b += batch_size)
         {
-            if(!table[i].empty())
+            size_t m = min(batch_size, n - b);
+            for(size_t k = 0; k < m; k++)
             {
-                out << i << "--> ";
-                for(int j=0; j < table[i].size(); j++)
-                {
-                    out << "<" << table[i][j].symbol << ", " << table[i][j].symbol_Type << "> ";
-                }
-                out << endl;
+                hashes[k] = hashValue(symbols[b + k]);
+                PREFETCH(&slots[home(hashes[k])]);
+            }
+            atoms.find_batch(symbols + b, hashes, m, found);
+            for(size_t k = 0; k < m; k++)
+            {
+                slot[b + k] = found[k] == Atoms::none ? -1 : findSlot(found[k], hashes[k]);
             }
         }
     }
 
-};
-
-int main()
-{
-    Symbol_Table table;
-    char operation;
-    string name, type;
-    ifstream input("C:\\Users\\sabit\\OneDrive\\Desktop\\Compiler\\Assignment_one_Symbol_Table\\input.txt");
-    ofstream output("C:\\Users\\sabit\\OneDrive\\Desktop\\Compiler\\Assignment_one_Symbol_Table\\output.txt");
-
-    if (!input || !output)
+    void Lookup_Batch(const string_view *symbols, size_t n, Out_Buffer &out)
     {
-        cerr << "Error opening files.\n";
-        return 1;
+        long long slot[batch_size];
+        for(size_t b = 0; b < n; b += batch_size)
+        {
+            size_t m = min(batch_size, n - b);
+            Find_Batch(symbols + b, m, slot);
+            for(size_t k = 0; k < m; k++)
+            {
+                STAT(lookups++);
+                Print_Lookup(slot[k], out);
+            }
+        }
     }
 
+    void Insert_Batch(const string_view *symbols, const string_view *types, size_t n, Out_Buffer &out)
+    {
+        unsigned int hashes[batch_size];
+        for(size_t b = 0; b < n; b += batch_size)
+        {
+            size_t m = min(batch_size, n - b);
+            for(size_t k = 0; k < m; k++)
+            {
+                hashes[k] = hashValue(symbols[b + k]);
+                PREFETCH(&slots[home(hashes[k])]);
+            }
+            atoms.prefetch(symbols + b, hashes, m);
+            for(size_t k = 0; k < m; k++) Insert(symbols[b + k], hashes[k], types[b + k], out);
+        }
+    }
 
-    while(input >> operation)
+    void Delete(string_view symbol, Out_Buffer &out) { Delete(symbol, hashValue(symbol), out); }
+    void Delete(string_view symbol, unsigned int hsh, Out_Buffer &out)
     {
-        if(operation == 'I')
+        STAT(deletes++);
+        unsigned int atom = atoms.find(symbol, hsh);
+        long long i = atom == Atoms::none ? -1 : findSlot(atom, hsh);
+        if(i < 0)
         {
-            input >> name >> type;
-            table.Insert(name, type, output);
+            out << "Not found.\n";
+            return;
         }
 
-        else if(operation == 'P')
+        out << "Deleted from " << home(slots[i].hash) << ',' << slots[i].dist << '\n';
+
+        // Backward shift: pull the rest of the run one step closer to home.
+        size_t j = i, next = (j + 1) & mask;
+        while(slots[next].dist > 0)
         {
-            table.Print(output);
+            slots[j] = std::move(slots[next]);
+            slots[j].dist--;
+            j = next;
+            next = (next + 1) & mask;
         }
+        slots[j] = Slot();
+        count--;
+    }
 
-        else if(operation == 'L')
+    // Entries sharing a home bucket sit next to each other, so each run of
+    // equal homes is printed as one line, like a chain.
+    // Runs near the end of the table may wrap into the first slots, so the
+    // walk starts after the wrapped entries and goes once around the table;
+    // every home then appears on one line, in ascending order.
+    // Large tables are cut into one chunk per thread at run boundaries;
+    // the chunks are formatted concurrently into memory buffers and
+    // written in order, one write each, so the output is the same bytes.
+    void Print(Out_Buffer &out)
+    {
+        size_t first = 0; // First slot not holding a wrapped entry
+        while(slots[first].dist > (int)first) first++;
+        size_t last = first + slots.size();
+        size_t threads = min<size_t>(thread::hardware_concurrency(), slots.size() / parallel_print_slots);
+        if(threads < 2)
+        {
+            Print_Range(first, last, out);
+            return;
+        }
+        vector<size_t> cut(threads + 1, last);
+        cut[0] = first;
+        for(size_t t = 1; t < threads; t++)
         {
-            input >> name;
-            table.Lookup(name, output);
+            size_t i = max(cut[t - 1], first + slots.size() * t / threads);
+            while(i < last && Same_Run(i - 1, i)) i++;
+            cut[t] = i;
         }
+        vector<Out_Buffer> parts(threads);
+        vector<thread> workers;
+        for(size_t t = 0; t < threads; t++)
+        {
+            workers.emplace_back([&, t]() { Print_Range(cut[t], cut[t + 1], parts[t]); });
+        }
+        for(size_t t = 0; t < threads; t++)
+        {
+            workers[t].join();
+            out.write(parts[t].text());
+        }
+    }
 
-        else if(operation == 'D')
+    // Whether positions a and b (taken modulo the capacity) hold entries
+    // of the same home.
+    bool Same_Run(size_t a, size_t b)
+    {
+        const Slot &x = slots[a & mask], &y = slots[b & mask];
+        return x.dist >= 0 && y.dist >= 0 && home(x.hash) == home(y.hash);
+    }
+
+    // Print() of the positions in [begin, end), taken modulo the capacity;
+    // begin must start a run.
+    void Print_Range(size_t begin, size_t end, Out_Buffer &out)
+    {
+        size_t i = begin;
+        while(i < end)
         {
-            input >> name;
-            table.Delete(name, output);
+            if(slots[i & mask].dist < 0)
+            {
+                i++;
+                continue;
+            }
+            size_t h = home(slots[i & mask].hash);
+            out << h << "--> ";
+            do
+            {
+                const Slot &e = slots[i & mask];
+                out << "<" << atoms.text(e.info.symbol) << ", " << atoms.text(e.info.symbol_Type) << "> ";
+                i++;
+            } while(i < end && Same_Run(i - 1, i));
+            out << '\n';
         }
     }
-    input.close();
-    output.close();
+
+    // Distribution of the current contents: home buckets in use, the longest
+    // run of one home (the open-addressing "chain"), probe distances, the
+    // share of symbols whose home is shared with another symbol, and how many
+    // symbols collide on the full 32-bit hash. A legacy policy is reported
+    // over its own modulus instead, with its position in the chain as the
+    // probe distance, as in the assignment it came from.
+    void Report()
+    {
+        size_t buckets = Hash_Policy::modulus ? Hash_Policy::modulus : slots.size();
+        vector<unsigned int> per_home(buckets, 0), hashes;
+        long long total_dist = 0;
+        int max_dist = 0;
+        for(size_t i = 0; i < slots.size(); i++)
+        {
+            if(slots[i].dist < 0) continue;
+            unsigned int &chain = per_home[Hash_Policy::modulus ? slots[i].hash % buckets : home(slots[i].hash)];
+            int d = Hash_Policy::modulus ? chain : slots[i].dist;
+            chain++;
+            hashes.push_back(slots[i].hash);
+            total_dist += d;
+            max_dist = max(max_dist, d);
+        }
+        size_t occupied = 0, max_chain = 0, shared = 0;
+        for(size_t h = 0; h < per_home.size(); h++)
+        {
+            if(per_home[h] > 0) occupied++;
+            if(per_home[h] > 1) shared += per_home[h];
+            max_chain = max(max_chain, (size_t)per_home[h]);
+        }
+        sort(hashes.begin(), hashes.end());
+        size_t full = hashes.size() - (unique(hashes.begin(), hashes.end()) - hashes.begin());
+
+        double n = count ? count : 1;
+        printf("%-12s symbols=%zu capacity=%zu occupied_buckets=%zu (%.1f%%) max_chain=%zu "
+               "mean_probe=%.3f max_probe=%d collision_rate=%.2f%% full_hash_collisions=%zu\n",
+               Hash_Policy::name(), count, buckets, occupied, 100.0 * occupied / buckets,
+               max_chain, total_dist / n, max_dist, 100.0 * shared / n, full);
+    }
+
+};
+
+// 64-bit file positions on every platform.
+int Seek(FILE *file, unsigned long long offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, offset, SEEK_SET);
+#else
+    return fseeko(file, offset, SEEK_SET);
+#endif
+}
+
+// Symbols moved out of memory, as one file of records sorted by (hash, name):
+//   uint32 hash, uint32 name length, uint32 type length, name, type
+// A sparse index keeps the hash and file offset of every index_every-th
+// record, so a lookup reads one or two small blocks. Deleting a spilled
+// symbol only sets its bit in deleted; merge() drops it from the file.
+// A Bloom filter over the record hashes (about filter_bits per record)
+// answers most lookups of symbols the run does not hold without a read.
+// Each merge writes a new file next to the old one and switches over only
+// once every record is written, so a failed merge leaves the run as it was.
+class Spill_Run
+{
+    struct Index_Entry
+    {
+        unsigned int hash;
+        unsigned long long offset;
+        size_t ordinal;
+    };
+
+    string base, path; // path is base.<generation>, empty before the first merge
+    unsigned int generation;
+    FILE *file;
+    vector<Index_Entry> index;
+    vector<bool> deleted;
+    vector<unsigned long long> filter;
+    unsigned long long file_size;
+    size_t live;
+    string block; // read buffer
+
+    static const size_t index_every = 64;
+    static const size_t header_size = 12;
+    static const size_t filter_bits = 10; // per record; about 1% false positives
+    static const int filter_probes = 3;
+
+    // Probes of the filter for hsh, which must be a power of two words long.
+    template<class F>
+    static void Probe(const vector<unsigned long long> &bits, unsigned int hsh, F f)
+    {
+        unsigned long long x = hsh * 0x9E3779B97F4A7C15ull, step = (x >> 32) | 1, m = bits.size() * 64 - 1;
+        for(int k = 0; k < filter_probes; k++, x += step) f(x & m);
+    }
+
+public:
+    struct Record
+    {
+        unsigned int hash;
+        string name, type;
+    };
+
+    Spill_Run(const string &base) : base(base), generation(0), file(NULL), file_size(0), live(0) {}
+    ~Spill_Run() { clear(); }
+
+    size_t size() { return live; }
+    size_t records() { return deleted.size(); }
+    size_t bytes()
+    {
+        return index.capacity() * sizeof(Index_Entry) + deleted.capacity() / 8 + filter.capacity() * 8 + block.capacity();
+    }
+
+    // Ordinal of the live record for name, or -1; its type goes to type.
+    long long find(string_view name, unsigned int hsh, string *type = NULL)
+    {
+        if(index.empty()) return -1;
+        bool maybe = true;
+        Probe(filter, hsh, [&](unsigned long long b) { maybe = maybe && (filter[b >> 6] >> (b & 63) & 1); });
+        if(!maybe) return -1;
+        auto after = upper_bound(index.begin(), index.end(), hsh,
+                                 [](unsigned int h, const Index_Entry &e) { return h < e.hash; });
+        if(after == index.begin()) return -1;
+        // Records with this hash may start in the block before the first
+        // indexed one that has it.
+        auto first = lower_bound(index.begin(), index.end(), hsh,
+                                 [](const Index_Entry &e, unsigned int h) { return e.hash < h; });
+        if(first != index.begin()) first--;
+        unsigned long long begin = first->offset, end = after == index.end() ? file_size : after->offset;
+
+        block.resize(end - begin);
+        if(Seek(file, begin) != 0 || fread(&block[0], 1, block.size(), file) != block.size()) return -1;
+        size_t ordinal = first->ordinal;
+        for(size_t at = 0; at + header_size <= block.size(); ordinal++)
+        {
+            unsigned int header[3];
+            memcpy(header, block.data() + at, header_size);
+            string_view text(block.data() + at + header_size, header[1]);
+            if(header[0] > hsh) break;
+            if(header[0] == hsh && text == name && !deleted[ordinal])
+            {
+                if(type) type->assign(block.data() + at + header_size + header[1], header[2]);
+                return ordinal;
+            }
+            at += header_size + header[1] + header[2];
+        }
+        return -1;
+    }
+
+    void erase(size_t ordinal)
+    {
+        deleted[ordinal] = true;
+        live--;
+    }
+
+    // Calls f(name, type) for every live record, in file order.
+    template<class F>
+    bool For_Each(F f)
+    {
+        Cursor c(*this);
+        for(const Record *r; (r = c.next());) f(r->name, r->type);
+        return !c.failed;
+    }
+
+    // Rewrites the run as the merge of its live records and fresh, which
+    // must be sorted by (hash, name) and hold no symbol already in the run.
+    bool merge(const vector<Record> &fresh)
+    {
+        Vector_Cursor c{fresh};
+        return merge_from(c);
+    }
+
+    // Moves every live record of other into this run and empties other.
+    bool absorb(Spill_Run &other)
+    {
+        Cursor c(other);
+        if(!merge_from(c)) return false;
+        other.clear();
+        return true;
+    }
+
+    void clear()
+    {
+        if(file) fclose(file);
+        if(!path.empty()) remove(path.c_str());
+        file = NULL;
+        path.clear();
+        index.clear();
+        deleted.clear();
+        filter.clear();
+        file_size = 0;
+        live = 0;
+    }
+
+private:
+    // Live records of a run in file order; failed is set by a short read.
+    struct Cursor
+    {
+        Spill_Run &run;
+        size_t ordinal;
+        Record r;
+        bool failed;
+
+        Cursor(Spill_Run &run) : run(run), ordinal(0), failed(run.file && Seek(run.file, 0) != 0) {}
+
+        size_t size() { return run.live; }
+
+        const Record *next()
+        {
+            while(!failed && ordinal < run.deleted.size())
+            {
+                if(!read(run.file, r)) failed = true;
+                else if(!run.deleted[ordinal++]) return &r;
+            }
+            return NULL;
+        }
+    };
+
+    struct Vector_Cursor
+    {
+        const vector<Record> &v;
+        size_t k;
+        bool failed;
+
+        size_t size() { return v.size(); }
+        const Record *next() { return k < v.size() ? &v[k++] : NULL; }
+    };
+
+    template<class Source>
+    bool merge_from(Source &fresh)
+    {
+        string next_path = base + "." + to_string(generation + 1);
+        FILE *out = fopen(next_path.c_str(), "wb");
+        if(!out) return false;
+        vector<Index_Entry> next_index;
+        size_t words = 1;
+        while(words * 64 < (live + fresh.size()) * filter_bits) words <<= 1;
+        vector<unsigned long long> next_filter(words);
+        unsigned long long offset = 0;
+        size_t written = 0;
+        bool ok = true;
+        auto put = [&](const Record &r) {
+            if(written % index_every == 0) next_index.push_back({r.hash, offset, written});
+            Probe(next_filter, r.hash, [&](unsigned long long b) { next_filter[b >> 6] |= 1ull << (b & 63); });
+            unsigned int header[3] = {r.hash, (unsigned int)r.name.size(), (unsigned int)r.type.size()};
+            ok = fwrite(header, 1, header_size, out) == header_size &&
+                 fwrite(r.name.data(), 1, r.name.size(), out) == r.name.size() &&
+                 fwrite(r.type.data(), 1, r.type.size(), out) == r.type.size();
+            offset += header_size + r.name.size() + r.type.size();
+            written++;
+        };
+
+        Cursor old(*this);
+        const Record *a = old.next(), *b = fresh.next();
+        while(ok && (a || b))
+        {
+            if(a && (!b || make_pair(a->hash, string_view(a->name)) < make_pair(b->hash, string_view(b->name))))
+            {
+                put(*a);
+                a = old.next();
+            }
+            else
+            {
+                put(*b);
+                b = fresh.next();
+            }
+        }
+        ok = fclose(out) == 0 && ok && !old.failed && !fresh.failed;
+        FILE *in = ok ? fopen(next_path.c_str(), "rb") : NULL;
+        if(!in)
+        {
+            remove(next_path.c_str());
+            return false;
+        }
+
+        if(file) fclose(file);
+        if(!path.empty()) remove(path.c_str());
+        file = in;
+        path = next_path;
+        generation++;
+        index.swap(next_index);
+        filter.swap(next_filter);
+        deleted.assign(written, false);
+        file_size = offset;
+        live = written;
+        return true;
+    }
+
+    static bool read(FILE *in, Record &r)
+    {
+        unsigned int header[3];
+        if(fread(header, 1, header_size, in) != header_size) return false;
+        r.hash = header[0];
+        r.name.resize(header[1]);
+        r.type.resize(header[2]);
+        return fread(&r.name[0], 1, header[1], in) == header[1] && fread(&r.type[0], 1, header[2], in) == header[2];
+    }
+};
+
+// Out-of-core mode: a Symbol_Table kept under a memory budget, backed by
+// Spill_Runs on disk. When the in-memory tier (table plus its atoms) goes
+// over the budget, every symbol not used since the previous spill is written
+// to a new run and the tier is rebuilt from the rest. The newest run is then
+// merged into the one before it while that one is no bigger, like carries in
+// a binary counter, so a record is rewritten O(log n) times and a lookup
+// checks O(log n) runs. Looking up a spilled symbol moves it back into
+// memory. Symbols in memory print their position as usual; spilled ones
+// print their run and record number. The budget is approximate: a spill
+// briefly needs about twice the tier's size. If a run cannot be written,
+// spilling stops and every symbol stays in memory.
+template<class Hash_Policy = FNV1a_Hash>
+class Spilling_Symbol_Table
+{
+    typedef Atom_Table<Hash_Policy> Atoms;
+    typedef Symbol_Table<Hash_Policy> Table;
+
+    size_t budget;
+    unique_ptr<Atoms> hot_atoms;
+    unique_ptr<Table> hot;
+    vector<bool> used; // by atom, since the last spill
+    string spill_path;
+    vector<unique_ptr<Spill_Run>> runs; // oldest (largest) first
+    Out_Buffer discard;
+    size_t spills, spilled, runs_made;
+    bool spill_failed;
+
+    void touch(long long slot)
+    {
+        unsigned int atom = hot->Symbol_At(slot);
+        if(atom >= used.size()) used.resize(max<size_t>(2 * used.size(), atom + 1));
+        used[atom] = true;
+    }
+
+    size_t bytes()
+    {
+        size_t total = hot_atoms->bytes() + hot->bytes() + used.capacity() / 8;
+        for(auto &run : runs) total += run->bytes();
+        return total;
+    }
+
+    // Run holding the live record for symbol and its ordinal there, or -1.
+    long long find_spilled(string_view symbol, unsigned int hsh, size_t &r, string *type = NULL)
+    {
+        for(r = runs.size(); r-- > 0;)
+        {
+            long long i = runs[r]->find(symbol, hsh, type);
+            if(i >= 0) return i;
+        }
+        return -1;
+    }
+
+    void erase_spilled(size_t r, size_t i)
+    {
+        runs[r]->erase(i);
+        if(runs[r]->size() == 0) runs.erase(runs.begin() + r);
+    }
+
+    void spill()
+    {
+        vector<Spill_Run::Record> cold, warm;
+        hot->For_Each([&](const Symbol_Info &info, unsigned int hsh) {
+            bool recent = info.symbol < used.size() && used[info.symbol];
+            Spill_Run::Record r{hsh, string(hot_atoms->text(info.symbol)), string(hot_atoms->text(info.symbol_Type))};
+            (recent ? warm : cold).push_back(std::move(r));
+        });
+        // Keep the recently used symbols only if they leave room to grow.
+        if(warm.size() * 4 > hot->size() || cold.empty())
+        {
+            cold.insert(cold.end(), make_move_iterator(warm.begin()), make_move_iterator(warm.end()));
+            warm.clear();
+        }
+        sort(cold.begin(), cold.end(), [](const Spill_Run::Record &a, const Spill_Run::Record &b) {
+            return make_pair(a.hash, string_view(a.name)) < make_pair(b.hash, string_view(b.name));
+        });
+        unique_ptr<Spill_Run> run(new Spill_Run(spill_path + "." + to_string(runs_made++)));
+        if(!run->merge(cold))
+        {
+            cerr << "Cannot write the spill file; keeping every symbol in memory.\n";
+            spill_failed = true;
+            return;
+        }
+        runs.push_back(std::move(run));
+        spills++;
+        spilled += cold.size();
+
+        hot.reset();
+        hot_atoms.reset(new Atoms());
+        hot.reset(new Table(*hot_atoms));
+        used.assign(used.size(), false);
+        for(const Spill_Run::Record &r : warm) hot->Insert(r.name, r.hash, r.type, discard);
+
+        while(runs.size() >= 2 && runs[runs.size() - 2]->size() <= runs.back()->size())
+        {
+            if(!runs[runs.size() - 2]->absorb(*runs.back()))
+            {
+                cerr << "Cannot merge the spill files; keeping every new symbol in memory.\n";
+                spill_failed = true;
+                return;
+            }
+            runs.pop_back();
+        }
+    }
+
+    void insert_hot(string_view symbol, unsigned int hsh, string_view type, Out_Buffer &out)
+    {
+        hot->Insert(symbol, hsh, type, out);
+        touch(hot->Find(symbol, hsh));
+        // A budget too small for the empty tier (or filled by the runs'
+        // indexes) must not spill every insert.
+        if(!spill_failed && bytes() > budget && hot->size() >= min_spill_symbols) spill();
+    }
+
+public:
+    Spilling_Symbol_Table(size_t budget, const string &spill_path)
+        : budget(budget), hot_atoms(new Atoms()), hot(new Table(*hot_atoms)), spill_path(spill_path), discard(NULL),
+          spills(0), spilled(0), runs_made(0), spill_failed(false) {}
+
+    size_t size()
+    {
+        size_t total = hot->size();
+        for(auto &run : runs) total += run->size();
+        return total;
+    }
+
+    void Insert(string_view symbol, string_view type, Out_Buffer &out)
+    {
+        unsigned int hsh = hot->hashValue(symbol);
+        long long i = hot->Find(symbol, hsh);
+        size_t r;
+        if(i >= 0)
+        {
+            touch(i);
+            out << "Symbol already exists.\n";
+        }
+        else if(find_spilled(symbol, hsh, r) >= 0) out << "Symbol already exists.\n";
+        else insert_hot(symbol, hsh, type, out);
+    }
+
+    void Lookup(string_view symbol, Out_Buffer &out)
+    {
+        unsigned int hsh = hot->hashValue(symbol);
+        long long i = hot->Find(symbol, hsh);
+        size_t r;
+        string type;
+        if(i >= 0)
+        {
+            touch(i);
+            hot->Print_Lookup(i, out);
+        }
+        else if((i = find_spilled(symbol, hsh, r, &type)) >= 0)
+        {
+            out << "Found symbol in spill run " << r << " at " << i << '\n';
+            erase_spilled(r, i);
+            insert_hot(symbol, hsh, type, discard);
+        }
+        else out << "Not found.\n";
+    }
+
+    void Delete(string_view symbol, Out_Buffer &out)
+    {
+        unsigned int hsh = hot->hashValue(symbol);
+        long long i = -1;
+        size_t r;
+        if(hot->Find(symbol, hsh) >= 0) hot->Delete(symbol, hsh, out);
+        else if((i = find_spilled(symbol, hsh, r)) >= 0)
+        {
+            out << "Deleted from spill run " << r << " at " << i << '\n';
+            erase_spilled(r, i);
+        }
+        else out << "Not found.\n";
+    }
+
+    void Insert_Batch(const string_view *symbols, const string_view *types, size_t n, Out_Buffer &out)
+    {
+        for(size_t k = 0; k < n; k++) Insert(symbols[k], types[k], out);
+    }
+
+    void Lookup_Batch(const string_view *symbols, size_t n, Out_Buffer &out)
+    {
+        for(size_t k = 0; k < n; k++) Lookup(symbols[k], out);
+    }
+
+    // The in-memory tier as usual, then the spilled symbols on one line.
+    void Print(Out_Buffer &out)
+    {
+        hot->Print(out);
+        if(runs.empty()) return;
+        out << "spilled--> ";
+        for(auto &run : runs)
+        {
+            if(!run->For_Each([&](const string &name, const string &type) { out << "<" << name << ", " << type << "> "; }))
+                cerr << "Cannot read the spill file.\n";
+        }
+        out << '\n';
+    }
+
+    void Report_Spills()
+    {
+        size_t on_disk = 0, records = 0;
+        for(auto &run : runs)
+        {
+            on_disk += run->size();
+            records += run->records();
+        }
+        fprintf(stderr, "%zu spills moved %zu symbols to disk; %zu in memory, %zu on disk in %zu runs (%zu records), ~%zu KiB in use\n",
+                spills, spilled, hot->size(), on_disk, runs.size(), records, bytes() >> 10);
+    }
+};
+
+// Pulls whitespace-separated words straight out of the mapped command file,
+// behaving like "input >> word" without going through iostreams.
+class Command_Reader
+{
+    const char *p, *end;
+
+public:
+    Command_Reader(const char *data, size_t size) : p(data), end(data + size) {}
+
+    bool skipSpace()
+    {
+        while(p < end && isspace((unsigned char)*p)) p++;
+        return p < end;
+    }
+
+    // Next operation character without consuming it, or 0 at the end.
+    char peek()
+    {
+        return skipSpace() ? *p : 0;
+    }
+
+    bool next(char &c)
+    {
+        if(!skipSpace()) return false;
+        c = *p++;
+        return true;
+    }
+
+    // word points into the mapped file; nothing is copied.
+    bool next(string_view &word)
+    {
+        if(!skipSpace()) return false;
+        const char *start = p;
+        while(p < end && !isspace((unsigned char)*p)) p++;
+        word = string_view(start, p - start);
+        return true;
+    }
+};
+
+// Replays every command of the file into table; returns how many were run.
+template<class Table>
+long long Run_Commands(Table &table, Command_Reader &commands, Out_Buffer &output)
+{
+    char operation;
+    string_view name;
+    string_view names[batch_size], types[batch_size];
+    long long count = 0;
+
+    while(commands.next(operation))
+    {
+        count++;
+        // Runs of consecutive inserts or lookups go through the batch calls.
+        if(operation == 'I')
+        {
+            size_t n = 0;
+            commands.next(names[n]);
+            commands.next(types[n++]);
+            while(n < batch_size && commands.peek() == 'I')
+            {
+                commands.next(operation);
+                commands.next(names[n]);
+                commands.next(types[n++]);
+                count++;
+            }
+            table.Insert_Batch(names, types, n, output);
+        }
+
+        else if(operation == 'P')
+        {
+            table.Print(output);
+        }
+
+        else if(operation == 'L')
+        {
+            size_t n = 0;
+            commands.next(names[n++]);
+            while(n < batch_size && commands.peek() == 'L')
+            {
+                commands.next(operation);
+                commands.next(names[n++]);
+                count++;
+            }
+            table.Lookup_Batch(names, n, output);
+        }
+
+        else if(operation == 'D')
+        {
+            commands.next(name);
+            table.Delete(name, output);
+        }
+    }
+    return count;
+}
+
+// Runs input through a fresh table using Hash_Policy and prints its report.
+template<class Hash_Policy>
+void Report_Policy(Mapped_File &input)
+{
+    Atom_Table<Hash_Policy> policy_atoms;
+    Symbol_Table<Hash_Policy> table(policy_atoms);
+    Command_Reader commands(input.data(), input.size());
+    Out_Buffer discard(NULL);
+    Run_Commands(table, commands, discard);
+    table.Report();
+}
+
+int Report(const string &policy, const char *input_path)
+{
+    Mapped_File input(input_path);
+    if(!input.ok())
+    {
+        cerr << "Error opening files.\n";
+        return 1;
+    }
+    bool all = policy == "all", any = false;
+    if(all || policy == Student_ID_Hash::name()) { Report_Policy<Student_ID_Hash>(input); any = true; }
+    if(all || policy == Even_Char_Hash::name()) { Report_Policy<Even_Char_Hash>(input); any = true; }
+    if(all || policy == First_Three_Hash::name()) { Report_Policy<First_Three_Hash>(input); any = true; }
+    if(all || policy == FNV1a_Hash::name()) { Report_Policy<FNV1a_Hash>(input); any = true; }
+    if(all || policy == Word_Mix_Hash::name()) { Report_Policy<Word_Mix_Hash>(input); any = true; }
+    if(!any)
+    {
+        cerr << "Unknown hash policy " << policy << ".\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Times Find one key at a time against Find_Batch on a table much larger
+// than L2. Keys are random, one in ten is absent, and no output is
+// formatted, so only the table walk itself is measured.
+int Bench_Batch(size_t symbols, size_t queries)
+{
+    Atom_Table<> bench_atoms;
+    Symbol_Table<> table(bench_atoms);
+    Out_Buffer discard(NULL);
+    vector<string> present(symbols), absent(queries / 10 + 1);
+    for(size_t i = 0; i < symbols; i++)
+    {
+        present[i] = "identifier_" + to_string(i);
+        table.Insert(present[i], "ID", discard);
+        discard.flush();
+    }
+    for(size_t i = 0; i < absent.size(); i++) absent[i] = "missing_" + to_string(i);
+
+    mt19937_64 rng(42);
+    vector<string_view> keys(queries);
+    for(size_t k = 0; k < queries; k++)
+    {
+        if(rng() % 10 == 0) keys[k] = absent[rng() % absent.size()];
+        else keys[k] = present[rng() % symbols];
+    }
+
+    auto start = chrono::steady_clock::now();
+    long long single_hits = 0;
+    for(size_t k = 0; k < queries; k++) single_hits += table.Find(keys[k]) >= 0;
+    double single = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    long long batch_hits = 0, slot[batch_size];
+    for(size_t b = 0; b < queries; b += batch_size)
+    {
+        size_t m = min(batch_size, queries - b);
+        table.Find_Batch(&keys[b], m, slot);
+        for(size_t k = 0; k < m; k++) batch_hits += slot[k] >= 0;
+    }
+    double batched = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    printf("symbols=%zu capacity=%zu queries=%zu hits=%lld/%lld\n",
+           table.size(), table.capacity(), queries, single_hits, batch_hits);
+    printf("one at a time: %.1f ns/lookup\n", 1e9 * single / queries);
+    printf("batch of %zu:   %.1f ns/lookup (%.2fx)\n", batch_size, 1e9 * batched / queries, single / batched);
+    return single_hits == batch_hits ? 0 : 1;
+}
+
+// Key ranks with P(rank r) proportional to 1/(r+1)^s, rank 0 the most
+// frequent, drawn by binary search in the cumulative weights.
+class Zipf_Distribution
+{
+    vector<double> cdf;
+
+public:
+    Zipf_Distribution(size_t n, double s) : cdf(n)
+    {
+        double sum = 0;
+        for(size_t r = 0; r < n; r++) cdf[r] = sum += 1.0 / pow(r + 1.0, s);
+    }
+
+    template<class Rng>
+    size_t operator()(Rng &rng)
+    {
+        double u = uniform_real_distribution<double>(0, cdf.back())(rng);
+        return min<size_t>(upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin(), cdf.size() - 1);
+    }
+};
+
+void Print_Latencies(const char *op, vector<long long> &ns)
+{
+    if(ns.empty()) return;
+    sort(ns.begin(), ns.end());
+    auto at = [&](double q) { return ns[min(ns.size() - 1, (size_t)(q * ns.size()))]; };
+    printf("  %-7s n=%-9zu p50=%lld ns  p99=%lld ns  p999=%lld ns\n", op, ns.size(), at(0.5), at(0.99), at(0.999));
+}
+
+// Runs a random mix of Insert/Lookup/Delete over 2*symbols names, half of
+// them inserted up front, once with uniformly chosen names and once with
+// Zipf(0.99) ones, and reports throughput and per-operation latency
+// percentiles. Each latency also includes one clock read (20-50 ns).
+int Bench_Mix(size_t symbols, size_t operations, int insert_pct, int delete_pct)
+{
+    mt19937_64 rng(42);
+    vector<string> keys(2 * symbols);
+    for(size_t i = 0; i < keys.size(); i++) keys[i] = "key_" + to_string(i);
+    shuffle(keys.begin(), keys.end(), rng); // rank -> name, so hot names are spread over the table
+
+    Zipf_Distribution zipf(keys.size(), 0.99);
+    const char *op_names[3] = {"insert", "lookup", "delete"};
+    for(int dist = 0; dist < 2; dist++)
+    {
+        Atom_Table<> bench_atoms;
+        Symbol_Table<> table(bench_atoms);
+        Out_Buffer discard(NULL);
+        for(size_t i = 0; i < keys.size(); i += 2) table.Insert(keys[i], "ID", discard);
+
+        vector<pair<int, size_t>> ops(operations);
+        for(size_t k = 0; k < operations; k++)
+        {
+            int roll = rng() % 100;
+            int op = roll < insert_pct ? 0 : roll < 100 - delete_pct ? 1 : 2;
+            ops[k] = {op, dist == 0 ? rng() % keys.size() : zipf(rng)};
+        }
+
+        vector<long long> latency[3];
+        auto start = chrono::steady_clock::now();
+        for(size_t k = 0; k < operations; k++)
+        {
+            string_view name = keys[ops[k].second];
+            auto t0 = chrono::steady_clock::now();
+            if(ops[k].first == 0) table.Insert(name, "ID", discard);
+            else if(ops[k].first == 1) table.Lookup(name, discard);
+            else table.Delete(name, discard);
+            auto t1 = chrono::steady_clock::now();
+            latency[ops[k].first].push_back(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count());
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        printf("%s: %zu symbols at start, %zu operations in %.3f s (%.2f Mops/s), %zu symbols at end\n",
+               dist == 0 ? "uniform" : "zipf(0.99)", symbols, operations, seconds, operations / seconds / 1e6, table.size());
+        for(int op = 0; op < 3; op++) Print_Latencies(op_names[op], latency[op]);
+    }
+    return 0;
+}
+
+// Fills a table, then runs lookups, duplicate inserts and lookups/deletes
+// of unknown names through both the plain and the pre-hashed overloads, and
+// checks that none of them touched the heap. Needs -DCOUNT_ALLOCATIONS.
+int Alloc_Check()
+{
+#ifndef COUNT_ALLOCATIONS
+    cerr << "Build with -DCOUNT_ALLOCATIONS to use --alloc-check.\n";
+    return 1;
+#else
+    vector<string> known, unknown;
+    for(int i = 0; i < 100000; i++)
+    {
+        known.push_back("symbol_" + to_string(i));
+        unknown.push_back("missing_" + to_string(i));
+    }
+    Atom_Table<> check_atoms;
+    Symbol_Table<> table(check_atoms);
+    Out_Buffer discard(NULL);
+    for(size_t i = 0; i < known.size(); i++) table.Insert(known[i], "INT", discard);
+    discard.flush();
+
+    long long before = allocation_count, operations = 0;
+    for(size_t i = 0; i < known.size(); i++)
+    {
+        string_view name = known[i];
+        unsigned int hsh = table.hashValue(name);
+        table.Lookup(name, discard);
+        table.Lookup(name, hsh, discard);
+        table.Insert(name, "INT", discard);
+        table.Insert(name, hsh, "INT", discard);
+        table.Lookup(unknown[i], discard);
+        table.Delete(unknown[i], discard);
+        operations += 6;
+    }
+    long long made = allocation_count - before;
+    printf("%lld operations on existing or unknown symbols made %lld allocations\n", operations, made);
+    return made == 0 ? 0 : 1;
+#endif
+}
+
+// Adds the symbol and type of every insert command in input_path to sketch.
+bool Sketch_Inserts(const char *input_path, Cardinality_Sketch &sketch)
+{
+    Mapped_File input(input_path);
+    if(!input.ok()) return false;
+    Command_Reader commands(input.data(), input.size());
+    char operation;
+    string_view word;
+    while(commands.next(operation))
+    {
+        if(operation == 'I')
+        {
+            commands.next(word);
+            sketch.add(word);
+            commands.next(word);
+            sketch.add(word);
+        }
+        else if(operation == 'L' || operation == 'D') commands.next(word);
+    }
+    return true;
+}
+
+// Replays input_path into table, writing to output_path. The number of
+// commands processed and the commands/second rate go to stderr.
+template<class Table>
+int Run_File(Table &table, const char *input_path, const char *output_path)
+{
+    Mapped_File input(input_path);
+    Out_Buffer output(output_path);
+
+    if (!input.ok() || !output.ok())
+    {
+        cerr << "Error opening files.\n";
+        return 1;
+    }
+
+    Command_Reader commands(input.data(), input.size());
+    auto start = chrono::steady_clock::now();
+    long long count = Run_Commands(table, commands, output);
+    output.close();
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << count << " commands in " << fixed << setprecision(3) << seconds << " s ("
+         << setprecision(0) << (seconds > 0 ? count / seconds : 0) << " commands/s)\n";
+    return 0;
+}
+
+// Usage: assignment1 [input.txt output.txt]
+//        assignment1 --memory-budget <MiB> input.txt output.txt
+//        assignment1 --presize input.txt output.txt
+//        assignment1 --report <student_id|even_char|first_three|fnv1a|word_mix|all> input.txt
+//        assignment1 --alloc-check
+//        assignment1 --bench-batch [symbols] [queries]
+//        assignment1 --bench-mix [symbols] [operations] [insert%/lookup%/delete%]
+// Without arguments the original input/output paths are used. With
+// --memory-budget, symbols beyond the budget are spilled to files named
+// output.txt.spill.*, which are removed at exit. --presize sizes the table from a first pass over
+// the input, so it never resizes; positions then follow the larger capacity.
+int main(int argc, char *argv[])
+{
+    if(argc >= 4 && string(argv[1]) == "--report") return Report(argv[2], argv[3]);
+    if(argc >= 2 && string(argv[1]) == "--alloc-check") return Alloc_Check();
+    if(argc >= 2 && string(argv[1]) == "--bench-batch")
+    {
+        size_t symbols = argc >= 3 ? strtoull(argv[2], NULL, 10) : 2000000;
+        size_t queries = argc >= 4 ? strtoull(argv[3], NULL, 10) : 10000000;
+        if(symbols < 1 || queries < 1)
+        {
+            cerr << "The benchmark needs at least one symbol and one query.\n";
+            return 1;
+        }
+        return Bench_Batch(symbols, queries);
+    }
+    if(argc >= 2 && string(argv[1]) == "--bench-mix")
+    {
+        size_t symbols = argc >= 3 ? strtoull(argv[2], NULL, 10) : 100000;
+        size_t operations = argc >= 4 ? strtoull(argv[3], NULL, 10) : 1000000;
+        int insert_pct = 10, lookup_pct = 80, delete_pct = 10;
+        if(argc >= 5 && (sscanf(argv[4], "%d/%d/%d", &insert_pct, &lookup_pct, &delete_pct) != 3
+                         || insert_pct + lookup_pct + delete_pct != 100))
+        {
+            cerr << "The mix must be three percentages adding up to 100, e.g. 10/80/10.\n";
+            return 1;
+        }
+        if(symbols < 1 || operations < 1)
+        {
+            cerr << "The benchmark needs at least one symbol and one operation.\n";
+            return 1;
+        }
+        return Bench_Mix(symbols, operations, insert_pct, delete_pct);
+    }
+    if(argc >= 4 && string(argv[1]) == "--presize")
+    {
+        auto start = chrono::steady_clock::now();
+        Cardinality_Sketch sketch;
+        if(!Sketch_Inserts(argv[2], sketch))
+        {
+            cerr << "Error opening files.\n";
+            return 1;
+        }
+        Symbol_Table<> table(atoms, sketch);
+        fprintf(stderr, "estimated %zu distinct spellings in %.3f s; capacity %zu\n", sketch.estimate(),
+                chrono::duration<double>(chrono::steady_clock::now() - start).count(), table.capacity());
+        return Run_File(table, argv[2], argv[3]);
+    }
+    if(argc >= 5 && string(argv[1]) == "--memory-budget")
+    {
+        size_t budget = strtoull(argv[2], NULL, 10) << 20;
+        Spilling_Symbol_Table<> table(budget, string(argv[4]) + ".spill");
+        int status = Run_File(table, argv[3], argv[4]);
+        table.Report_Spills();
+        return status;
+    }
+
+    Symbol_Table<> table(atoms);
+    const char *input_path = "C:\\Users\\sabit\\OneDrive\\Desktop\\Compiler\\Assignment_one_Symbol_Table\\input.txt";
+    const char *output_path = "C:\\Users\\sabit\\OneDrive\\Desktop\\Compiler\\Assignment_one_Symbol_Table\\output.txt";
+    if(argc >= 3)
+    {
+        input_path = argv[1];
+        output_path = argv[2];
+    }
+    return Run_File(table, input_path, output_path);
 }
@@ -0,0 +1,120 @@
+// Helpers for the hand tokenizer's (tokenization.cpp) benchmarks: random
+// identifier names, Zipf-distributed key ranks, random operation mixes and
+// latency percentiles.
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// count distinct identifier-like names, 3 to 10 lowercase letters
+// Random rather than numbered: a hash that reads only a few characters
+// (like the tokenizer's hashFunc) would put "key_1", "key_2", ... in one bucket.
+inline std::vector<std::string> randomIdentifiers(size_t count, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> names;
+    names.reserve(count);
+    while (names.size() < count)
+    {
+        std::string name(3 + rng() % 8, ' ');
+        for (char &c : name)
+            c = 'a' + rng() % 26;
+        if (seen.insert(name).second)
+            names.push_back(name);
+    }
+    return names;
+}
+
+// Key ranks for the mixed benchmarks: P(rank r) is proportional to
+// 1/(r+1)^s, rank 0 the most frequent
+class ZipfDistribution
+{
+    std::vector<double> cdf; // Cumulative weights, one per rank
+
+public:
+    ZipfDistribution(size_t n, double s) : cdf(n)
+    {
+        double sum = 0;
+        for (size_t r = 0; r < n; r++)
+            cdf[r] = sum += 1.0 / std::pow(r + 1.0, s);
+    }
+
+    // Binary search for a uniform point in the cumulative weights
+    template <class Rng>
+    size_t operator()(Rng &rng)
+    {
+        double u = std::uniform_real_distribution<double>(0, cdf.back())(rng);
+        return std::min<size_t>(std::upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin(), cdf.size() - 1);
+    }
+};
+
+// Operations of a mixed benchmark
+enum MixOp
+{
+    MIX_INSERT,
+    MIX_LOOKUP,
+    MIX_DELETE
+};
+
+// operations random (operation, key rank) pairs: insertPct% inserts,
+// deletePct% deletes and the rest lookups; ranks are uniform over
+// keyCount, or drawn from zipf when it is given
+inline std::vector<std::pair<MixOp, size_t>> mixOperations(size_t operations, size_t keyCount, ZipfDistribution *zipf,
+                                                           int insertPct, int deletePct, std::mt19937_64 &rng)
+{
+    std::vector<std::pair<MixOp, size_t>> ops(operations);
+    for (auto &op : ops)
+    {
+        int roll = rng() % 100;
+        op.first = roll < insertPct ? MIX_INSERT : roll < 100 - deletePct ? MIX_LOOKUP : MIX_DELETE;
+        op.second = zipf ? (*zipf)(rng) : rng() % keyCount;
+    }
+    return ops;
+}
+
+// Latencies of each operation in one benchmark pass
+// Every sample also includes one clock read (20-50 ns).
+class LatencyLog
+{
+    std::vector<long long> ns[3]; // Indexed by MixOp
+
+public:
+    // Run f and record how long it took as one op
+    template <class F>
+    void time(MixOp op, F f)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        ns[op].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+
+    // p50/p99/p999 of every operation that ran
+    void print()
+    {
+        const char *names[3] = {"insert", "lookup", "delete"};
+        for (int op = 0; op < 3; op++)
+        {
+            std::vector<long long> &v = ns[op];
+            if (v.empty())
+                continue;
+            std::sort(v.begin(), v.end());
+            auto at = [&](double q) { return v[std::min(v.size() - 1, (size_t)(q * v.size()))]; };
+            printf("  %-7s n=%-9zu p50=%lld ns  p99=%lld ns  p999=%lld ns\n", names[op], v.size(), at(0.5),
+                   at(0.99), at(0.999));
+        }
+    }
+};
+
+#endif
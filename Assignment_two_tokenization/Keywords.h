@@ -0,0 +1,89 @@
+// Keyword recognition with a perfect hash built at compile time
+// KEYWORDS is the hand tokenizer's (tokenization.cpp) keyword list; a
+// lookup is one hash and at most one string compare. The flex specs in
+// Assignment_three_Lex keep their own lists (each lexer recognises its own
+// language) and their own copy of KeywordSet.
+
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+// List of C++ keywords to recognize
+constexpr std::string_view KEYWORDS[] = {"if", "else", "else if", "for", "while", "do", "break", "int", "void",
+                                         "char", "float", "double", "unsigned", "const", "return", "include"};
+
+// FNV-1a over the spelling, started from a seed
+constexpr uint32_t keywordHash(std::string_view s, uint32_t seed)
+{
+    uint32_t h = 2166136261u ^ seed;
+    for (char c : s)
+        h = (h ^ (unsigned char)c) * 16777619u;
+    return h ^ (h >> 15);
+}
+
+// Perfect hash over a fixed list of words
+// The constructor tries seeds until every word lands in its own slot, so
+// a lookup reads one slot and compares against the single word stored
+// there. With four slots per word a seed is found after a few tries.
+// The search runs at compile time when the set is declared constexpr.
+template <size_t N>
+class KeywordSet
+{
+    static constexpr size_t slotCount()
+    {
+        size_t n = 1;
+        while (n < 4 * N)
+            n <<= 1;
+        return n;
+    }
+
+public:
+    static constexpr size_t SLOTS = slotCount(); // Power of two, at least 4 slots per word
+    static_assert(N < 256, "slot indexes are stored in one byte");
+
+    constexpr KeywordSet(const std::string_view (&list)[N]) : words(list)
+    {
+        for (;; seed++)
+        {
+            if (seed == 1u << 16)
+                throw std::logic_error("no perfect hash seed for this keyword list");
+            for (size_t i = 0; i < SLOTS; i++)
+                slot[i] = 0;
+            bool collision = false;
+            for (size_t i = 0; i < N && !collision; i++)
+            {
+                size_t s = keywordHash(list[i], seed) & (SLOTS - 1);
+                collision = slot[s] != 0;
+                slot[s] = i + 1;
+            }
+            if (!collision)
+                return; // Every word has a slot of its own
+        }
+    }
+
+    // Position of s in the list, or -1 when it is not a keyword
+    constexpr int find(std::string_view s) const
+    {
+        int i = slot[keywordHash(s, seed) & (SLOTS - 1)];
+        return i && words[i - 1] == s ? i - 1 : -1;
+    }
+
+    constexpr bool contains(std::string_view s) const
+    {
+        return find(s) >= 0;
+    }
+
+private:
+    const std::string_view *words;  // The list the set was built from
+    uint32_t seed = 0;              // First seed that gave no collisions
+    unsigned char slot[SLOTS] = {}; // Word index + 1, 0 for an empty slot
+};
+
+constexpr KeywordSet<std::size(KEYWORDS)> keywordSet(KEYWORDS);
+
+#endif
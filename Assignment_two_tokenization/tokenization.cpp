@@ -3,29 +3,188 @@
 // It identifies keywords, identifiers, operators, numbers, literals, and functions
 
 #include <bits/stdc++.h>
+#ifndef _WIN32
+#include <fcntl.h>    // open() for the memory-mapped input mode
+#include <sys/mman.h> // mmap()
+#include <sys/stat.h> // fstat() for the file size
+#include <unistd.h>   // close()
+#endif
+#include "Keywords.h"  // Keyword list and its compile-time perfect hash
+#include "Benchmark.h" // Names, Zipf ranks and latency percentiles for the benchmarks
 using namespace std;
 
+/// Allocation counter for --bench-mmap, only compiled with -DCOUNT_ALLOCATIONS
+#ifdef COUNT_ALLOCATIONS
+static long long allocationCount = 0;
+void *operator new(size_t n)
+{
+    allocationCount++;
+    if (void *p = malloc(n ? n : 1))
+        return p;
+    throw bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+#endif
+
 /// Hash table size is 12 (mod value for hash function)
 /// Global output file for symbol table operations
 ofstream fileout("output.txt", ios_base ::out);
-// Function to check if a character is valid for identifiers or keywords
-// Valid characters: alphanumeric (a-z, A-Z, 0-9) and underscore (_)
-bool idOrKey(char ch)
+
+/// print() formats buckets on one thread per this many symbols
+const size_t PARALLEL_PRINT_SYMBOLS = 1 << 16;
+
+/// Symbol table instrumentation, only compiled with -DSYMTAB_STATS
+/// STAT(...) expands to nothing otherwise, so normal builds pay nothing.
+/// At exit the counters are written as JSON to $SYMTAB_STATS_FILE
+/// (default symtab_stats.json).
+#ifdef SYMTAB_STATS
+struct TableStats
+{
+    static const int BUCKETS = 33; // Chain entries examined: 0..31, last one is 32+
+    long long inserts = 0, duplicates = 0, lookups = 0, deletes = 0;
+    long long comparisons = 0, atomProbes = 0, maxChain = 0;
+    long long chainHistogram[BUCKETS] = {};
+
+    // Record how many chain entries one lookup walked
+    void examined(long long n)
+    {
+        chainHistogram[min(n, (long long)BUCKETS - 1)]++;
+    }
+
+    // Dump everything when the program ends
+    ~TableStats()
+    {
+        const char *path = getenv("SYMTAB_STATS_FILE");
+        FILE *f = fopen(path ? path : "symtab_stats.json", "w");
+        if (!f)
+            return;
+        fprintf(f, "{\"table\": \"tokenizer\", \"inserts\": %lld, \"duplicates\": %lld, \"lookups\": %lld, "
+                   "\"deletes\": %lld, \"comparisons\": %lld, \"atom_probes\": %lld, \"resizes\": 0, "
+                   "\"max_chain\": %lld, \"chain_histogram\": [",
+                inserts, duplicates, lookups, deletes, comparisons, atomProbes, maxChain);
+        for (int i = 0; i < BUCKETS; i++)
+            fprintf(f, "%s%lld", i ? ", " : "", chainHistogram[i]);
+        fprintf(f, "]}\n");
+        fclose(f);
+    }
+};
+TableStats tableStats;
+#define STAT(x) (tableStats.x)
+#else
+#define STAT(x) ((void)0)
+#endif
+
+// CHARACTER CLASS TABLES - built at compile time
+// Every character classifier below is one table load
+// instead of building a vector and searching it on each call.
+enum CharFlag : unsigned char
+{
+    ID_CHAR = 1,         // a-z, A-Z, 0-9 and _ (part of identifier/keyword)
+    SPACE_CHAR = 2,      // Space, newline and tab
+    PUNC_CHAR = 4,       // Punctuation that is not an operator
+    INTERRUPT_CHAR = 8   // Brackets and punctuation end the current token
+};
+
+// List of all supported operators in C++
+constexpr string_view OPERATORS[] = {"+", "-", "*", "%", "&&", "||", "&", "|", "<<", ">>", "=", "+=", "/=",
+                                     "%=", "!", "!=", "-=", "==", ">", "<", "!", "<<=", ">>="};
+
+struct CharTables
+{
+    unsigned char flags[256] = {}; // CharFlag bits for every byte
+};
+
+constexpr CharTables buildCharTables()
 {
-    if ((ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_')
+    CharTables t{};
+    for (int c = 0; c < 256; c++)
     {
-        return true; // Character can be part of identifier/keyword
+        if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')
+            t.flags[c] |= ID_CHAR;
     }
-    return false; // Character cannot be part of identifier/keyword
+    for (char c : {' ', '\n', '\t'})
+        t.flags[(unsigned char)c] |= SPACE_CHAR;
+    for (char c : {',', '.', ';', '?', ':'})
+        t.flags[(unsigned char)c] |= PUNC_CHAR | INTERRUPT_CHAR;
+    for (char c : {'(', ')', '{', '}', '[', ']'})
+        t.flags[(unsigned char)c] |= INTERRUPT_CHAR;
+    return t;
+}
+
+constexpr CharTables charTables = buildCharTables();
+
+// OPERATOR DFA - built at compile time from OPERATORS
+// The states are the prefixes of the operators (a trie). Input bytes are
+// first mapped to a column, 0 for bytes that appear in no operator, and
+// column 0 never has a transition. Running until there is no transition
+// and remembering the last accepting state gives maximal munch.
+struct OperatorDfa
+{
+    static const int MAX_STATES = 32, MAX_COLUMNS = 16; // Exceeding either fails to compile
+    unsigned char column[256] = {};                      // Column of each operator character
+    unsigned char next[MAX_STATES][MAX_COLUMNS] = {};    // Next state, 0 = no transition
+    bool accepting[MAX_STATES] = {};                     // A whole operator ends in this state
+};
+
+constexpr OperatorDfa buildOperatorDfa()
+{
+    OperatorDfa d{};
+    int columns = 1, states = 1; // State 0 is the start state
+    for (string_view o : OPERATORS)
+    {
+        int state = 0;
+        for (char ch : o)
+        {
+            unsigned char c = ch;
+            if (!d.column[c])
+                d.column[c] = columns++; // First time this character appears
+            if (!d.next[state][d.column[c]])
+                d.next[state][d.column[c]] = states++; // New prefix
+            state = d.next[state][d.column[c]];
+        }
+        d.accepting[state] = true;
+    }
+    return d;
+}
+
+constexpr OperatorDfa operatorDfa = buildOperatorDfa();
+
+// Length of the longest operator starting at s[i], 0 if there is none
+// Stops at the end of s, so an operator at the end of a line is safe.
+inline size_t longestOperator(string_view s, size_t i)
+{
+    size_t longest = 0;
+    int state = 0;
+    for (size_t j = i; j < s.size(); j++)
+    {
+        state = operatorDfa.next[state][operatorDfa.column[(unsigned char)s[j]]];
+        if (!state)
+            break; // No operator continues with this character
+        if (operatorDfa.accepting[state])
+            longest = j - i + 1;
+    }
+    return longest;
+}
+
+// Function to check if a character is valid for identifiers or keywords
+// Valid characters: alphanumeric (a-z, A-Z, 0-9) and underscore (_)
+inline bool idOrKey(char ch)
+{
+    return charTables.flags[(unsigned char)ch] & ID_CHAR;
 }
 
 // Function to check if a string represents a valid number
 // Supports integers (123), negative numbers (-45), and floating point (12.34, .5)
-bool digit(string a)
+bool digit(string_view a)
 {
     int cnt = 0; // Counter for decimal points
     int n = a.size();
 
+    // Empty token is not a number
+    if (a.empty())
+        return false;
+
     // First character validation: must be digit, negative sign, or decimal point
     if (a[0] != '-' && !(a[0] >= '0' && a[0] <= '9') && a[0] != '.')
         return false;
@@ -55,7 +214,7 @@ bool digit(string a)
 // Rules: 1) Can contain alphanumeric and underscore only
 //        2) Cannot be empty
 //        3) Cannot start with a digit
-bool id(string s) /// identifier
+bool id(string_view s) /// identifier
 {
     // Check if all characters are valid for identifiers
     for (int i = 0; i < s.size(); i++)
@@ -77,60 +236,38 @@ bool id(string s) /// identifier
 
 // Function to check if a string is a valid operator
 // Supports both single and multi-character operators
-bool op(string ch)
+inline bool op(string_view ch)
 {
-    // List of all supported operators in C++
-    vector<string> op = {"+", "-", "*", "%", "&&", "||", "&", "|", "<<", ">>", "=", "+=", "/=",
-                         "%=", "!", "!=", "-=", "==", ">", "<", "!"};
-
-    // Check if the input string matches any operator
-    if (find(op.begin(), op.end(), ch) != op.end())
-        return true; // Found matching operator
-    return false;    // Not an operator
+    return !ch.empty() && longestOperator(ch, 0) == ch.size(); // The whole string is one operator
 }
 
 // Function to check if a character is whitespace
 // Recognizes space, newline, and tab characters
-bool space(char ch)
+inline bool space(char ch)
 {
-    if (ch == ' ' || ch == '\n' || ch == '\t')
-        return true; // Whitespace character
-    return false;    // Not whitespace
+    return charTables.flags[(unsigned char)ch] & SPACE_CHAR;
 }
 
 // Function to check if a character is punctuation
 // Used for punctuation marks that are not operators
-bool punc(char ch)
+inline bool punc(char ch)
 {
-    vector<char> punc = {',', '.', ';', '?', ':'}; // Punctuation characters
-    if (find(punc.begin(), punc.end(), ch) != punc.end())
-        return true; // Found punctuation
-    return false;    // Not punctuation
+    return charTables.flags[(unsigned char)ch] & PUNC_CHAR;
 }
 
 // Function to check if a string is a C++ keyword
 // Contains all major C++ keywords used in basic programming
-bool keyword(string a)
+// (KEYWORDS in Keywords.h, one perfect-hash probe and one compare)
+inline bool keyword(string_view a)
 {
-    // List of C++ keywords to recognize
-    vector<string> key = {"if", "else", "else if", "for", "while", "do", "break", "int", "void",
-                          "char", "float", "double", "unsigned", "const", "return", "include"};
-
-    // Check if input string matches any keyword
-    if (find(key.begin(), key.end(), a) != key.end())
-        return true; // Found keyword
-    return false;    // Not a keyword
+    return keywordSet.contains(a);
 }
 
 // Function to check if a character interrupts token building
 // These characters signal the end of a token (brackets, punctuation)
-bool interrupt(char ch)
+inline bool interrupt(char ch)
 {
-    // Characters that separate tokens
-    vector<char> bracket = {'(', ')', '{', '}', '[', ']', ',', '.', ';', '?', ':'};
-    if (find(bracket.begin(), bracket.end(), ch) != bracket.end())
-        return true; // Character interrupts token building
-    return false;    // Character doesn't interrupt token building
+    return charTables.flags[(unsigned char)ch] & INTERRUPT_CHAR;
 }
 
 void lexicalError(string line, char errorChar)
@@ -140,42 +277,326 @@ void lexicalError(string line, char errorChar)
     cout << "Lexical error at line " << line << " and error is: " << errorChar << endl;
 }
 
+// Read-only view of a whole source file
+// Mapped into memory where mmap is available, read in one go otherwise,
+// so tokens can point straight into it
+class MappedFile
+{
+    const char *ptr = nullptr; // First byte of the file (nullptr if it could not be opened)
+    size_t len = 0;            // File size in bytes
+    string fallback;           // File contents when mmap is not used
+    bool mapped = false;       // Whether ptr must be unmapped
+
+public:
+    MappedFile(const char *path)
+    {
+#ifndef _WIN32
+        int fd = open(path, O_RDONLY);
+        if (fd < 0)
+            return; // No such file
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+            st.st_size = -1;
+        if (st.st_size == 0)
+            ptr = ""; // Empty file, nothing to map
+        else if (st.st_size > 0)
+        {
+            void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                madvise(p, st.st_size, MADV_SEQUENTIAL); // Read front to back once
+                ptr = (const char *)p;
+                len = st.st_size;
+                mapped = true;
+            }
+        }
+        close(fd);
+        if (ptr)
+            return;
+#endif
+        ifstream in(path, ios::binary); // Fallback: one read of the whole file
+        if (!in)
+            return;
+        fallback.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        ptr = fallback.data();
+        len = fallback.size();
+    }
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (mapped)
+            munmap((void *)ptr, len);
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool ok() const { return ptr != nullptr; }
+    string_view text() const { return string_view(ptr, len); }
+};
+
+// Kinds of token the scanner hands out
+enum TokenKind
+{
+    WORD,      // Run of identifier characters: keyword, identifier, function or number
+    OPERATOR,  // Longest operator at this position
+    LITERAL,   // String literal with its quotes, may span lines
+    SEPARATOR, // Bracket or punctuation
+    UNKNOWN    // Any other character, or a literal without its closing quote
+};
+
+// One token: a view into the source plus where it starts
+struct Token
+{
+    TokenKind kind;
+    string_view text; // Points into the source, nothing is copied
+    int line, column; // 1-based position of the first character
+};
+
+// Zero-copy tokenizer over a whole source buffer
+// Works on the buffer as one piece instead of line by line, so string
+// literals and /* */ comments may span lines. Comments are skipped, and
+// no token allocates: each one is a string_view into the buffer.
+class Scanner
+{
+    const char *p, *end;   // Next character to read and end of the buffer
+    const char *lineStart; // First character of the current line
+    int line = 1;          // Current line number
+
+    // Step over one character, keeping the line count
+    void advance()
+    {
+        if (*p++ == '\n')
+        {
+            line++;
+            lineStart = p;
+        }
+    }
+
+public:
+    Scanner(string_view src) : p(src.data()), end(src.data() + src.size()), lineStart(src.data()) {}
+
+    // Read the next token into t; false at the end of the buffer
+    bool next(Token &t)
+    {
+        while (p < end)
+        {
+            char c = *p;
+            if (space(c) || c == '\r') // Whitespace between tokens
+            {
+                advance();
+                continue;
+            }
+            if (c == '/' && p + 1 < end && p[1] == '/') // Line comment: skip to the newline
+            {
+                while (p < end && *p != '\n')
+                    p++;
+                continue;
+            }
+            if (c == '/' && p + 1 < end && p[1] == '*') // Block comment: skip past */
+            {
+                p += 2;
+                while (p < end && !(*p == '*' && p + 1 < end && p[1] == '/'))
+                    advance();
+                p = min(p + 2, end);
+                continue;
+            }
+
+            const char *start = p;
+            t.line = line;
+            t.column = start - lineStart + 1;
+            if (c == '"') // String literal, up to the closing quote
+            {
+                p++;
+                while (p < end && *p != '"')
+                {
+                    if (*p == '\\' && p + 1 < end)
+                        p++; // An escaped character never closes the literal
+                    advance();
+                }
+                t.kind = p < end ? LITERAL : UNKNOWN; // No closing quote before the end
+                if (p < end)
+                    p++;
+            }
+            else if (idOrKey(c)) // Identifier, keyword or number
+            {
+                while (p < end && idOrKey(*p))
+                    p++;
+                t.kind = WORD;
+            }
+            else if (size_t len = longestOperator(string_view(p, end - p), 0)) // Maximal munch
+            {
+                p += len;
+                t.kind = OPERATOR;
+            }
+            else
+            {
+                p++;
+                t.kind = interrupt(c) ? SEPARATOR : UNKNOWN;
+            }
+            t.text = string_view(start, p - start);
+            return true;
+        }
+        return false; // End of the buffer
+    }
+
+    // Character right after t in the buffer ('\0' at the end)
+    char after(const Token &t) const
+    {
+        const char *q = t.text.data() + t.text.size();
+        return q < end ? *q : '\0';
+    }
+};
+
+// String interning service (atom table)
+// Every distinct spelling (identifier, keyword, literal, type name) is stored
+// once in a single character pool and given a stable 32-bit id (an "atom").
+// Symbols hold atoms instead of strings, so comparing two symbols is an
+// integer compare and repeated tokens never copy their text again.
+class AtomTable
+{
+    struct Entry
+    {
+        unsigned int offset, length, hash; // Location of the spelling in pool and its hash
+    };
+
+    string pool;                 // All interned spellings, back to back
+    vector<Entry> entries;       // Indexed by atom
+    vector<unsigned int> index;  // Open-addressing index: atom + 1, 0 means empty
+
+    // FNV-1a hash over the full spelling
+    static unsigned int hashText(string_view text)
+    {
+        unsigned int h = 2166136261u;
+        for (unsigned char c : text)
+            h = (h ^ c) * 16777619u;
+        return h;
+    }
+
+    // Find the index slot holding text, or the empty slot where it belongs
+    size_t probe(string_view text, unsigned int h)
+    {
+        size_t mask = index.size() - 1, i = h & mask;
+        while (index[i] != 0)
+        {
+            STAT(atomProbes++);
+            const Entry &e = entries[index[i] - 1];
+            if (e.hash == h && e.length == text.size() && pool.compare(e.offset, e.length, text) == 0)
+                break; // Same spelling already interned
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    // Double the index once it is half full
+    void grow()
+    {
+        index.assign(index.size() * 2, 0);
+        size_t mask = index.size() - 1;
+        for (size_t a = 0; a < entries.size(); a++)
+        {
+            size_t i = entries[a].hash & mask;
+            while (index[i] != 0)
+                i = (i + 1) & mask;
+            index[i] = a + 1;
+        }
+    }
+
+public:
+    static const unsigned int NONE = 0xFFFFFFFFu; // Returned by find() for unknown text
+
+    AtomTable() : index(64, 0) {}
+
+    // Look up the atom of text without interning it
+    unsigned int find(string_view text)
+    {
+        size_t i = probe(text, hashText(text));
+        return index[i] == 0 ? NONE : index[i] - 1;
+    }
+
+    // Return the atom of text, storing the spelling the first time it is seen
+    unsigned int intern(string_view text)
+    {
+        unsigned int h = hashText(text);
+        size_t i = probe(text, h);
+        if (index[i] != 0)
+            return index[i] - 1; // Already interned
+
+        entries.push_back({(unsigned int)pool.size(), (unsigned int)text.size(), h});
+        pool.append(text.data(), text.size());
+        index[i] = entries.size();
+        if (entries.size() * 2 > index.size())
+            grow();
+        return entries.size() - 1;
+    }
+
+    // Get the spelling behind an atom
+    string text(unsigned int atom)
+    {
+        return string(view(atom));
+    }
+
+    // Same, without copying; valid until the next intern()
+    string_view view(unsigned int atom)
+    {
+        return string_view(pool).substr(entries[atom].offset, entries[atom].length);
+    }
+};
+
+/// Global atom table shared by the tokenizer and the symbol table
+AtomTable atoms;
+
 // Class to store information about each symbol (token)
 // Each symbol has a name and its type (keyword, identifier, etc.)
+// Both are kept as atoms from the global atom table
 class SymbolInfo
 {
-    string symbol, symbolType; // Symbol name and its classification
+    unsigned int symbol, symbolType; // Atoms of the symbol name and its classification
 
 public:
     // Constructor to create a new symbol with its type
-    SymbolInfo(string symbol, string symbolType)
+    SymbolInfo(string_view symbol, string_view symbolType)
+    {
+        this->symbol = atoms.intern(symbol);
+        this->symbolType = atoms.intern(symbolType);
+    }
+
+    // Getter method to retrieve the atom of the symbol name
+    unsigned int getAtom()
     {
-        this->symbol = symbol;
-        this->symbolType = symbolType;
+        return symbol;
+    }
+
+    // Getter method to retrieve the atom of the symbol type
+    unsigned int getTypeAtom()
+    {
+        return symbolType;
     }
 
     // Getter method to retrieve symbol name
     string getSymbol()
     {
-        return symbol;
+        return atoms.text(symbol);
     }
 
     // Getter method to retrieve symbol type
     string getSymbolType()
     {
-        return symbolType;
+        return atoms.text(symbolType);
     }
 
     // Setter method to update symbol name
     void setSymbol(string symbol)
     {
-        this->symbol = symbol;
+        this->symbol = atoms.intern(symbol);
     }
 
     // Setter method to update symbol type
     void setSymbolType(string symbolType)
     {
-        this->symbolType = symbolType;
+        this->symbolType = atoms.intern(symbolType);
     }
 };
 
@@ -185,37 +606,78 @@ public:
 class SymbolTable
 {
     vector<SymbolInfo> table[12]; // Array of vectors for chaining
+    bool changeLog = false;       // Log only the inserted entry instead of the whole table
+    string lines[12];             // print() output, one line per bucket
 
 public:
+    // Output modes for insertVal:
+    //  full dump (default)  - the whole table is printed after every insert
+    //  change log           - only the new entry is printed, so output.txt
+    //                         grows linearly with the number of symbols;
+    //                         call print() once at the end for a final dump
+    void setChangeLog(bool on)
+    {
+        changeLog = on;
+    }
+
     // Insert a new symbol into the symbol table
-    void insertVal(string symbol, string symbolType)
+    // Names are taken as string_view, so nothing is copied unless the
+    // symbol is new (then its spelling is interned once)
+    void insertVal(string_view symbol, string_view symbolType)
     {
-        bool b = lookup(symbol); // Check if symbol already exists
-        if (b == false)          // Symbol doesn't exist, safe to insert
+        int hashVal = hashFunc(symbol);  // Calculate hash value once
+        bool b = lookup(symbol, hashVal); // Check if symbol already exists
+        if (b == false)                   // Symbol doesn't exist, safe to insert
         {
             SymbolInfo obj = SymbolInfo(symbol, symbolType); // Create new symbol
-            int hashVal = hashFunc(symbol);                  // Calculate hash value
             table[hashVal].push_back(obj);                   // Add to appropriate bucket
+            STAT(inserts++);
+            STAT(maxChain = max(tableStats.maxChain, (long long)table[hashVal].size()));
             int pos = table[hashVal].size();                 // Get position in bucket
-            fileout << "Inserted at position " << hashVal << "," << pos - 1 << endl;
-            print(); // Display updated table
+            if (changeLog) // Just the delta: position and the new entry
+            {
+                fileout << "Inserted at position " << hashVal << "," << pos - 1
+                        << " <" << symbol << "," << symbolType << ">\n";
+            }
+            else
+            {
+                fileout << "Inserted at position " << hashVal << "," << pos - 1 << endl;
+                print(); // Display updated table
+            }
         }
         else // Symbol already exists
         {
+            STAT(duplicates++);
             fileout << "Value already exists" << endl;
         }
     }
 
     // Search for a symbol in the symbol table
-    bool lookup(string symbol)
+    bool lookup(string_view symbol)
+    {
+        return lookup(symbol, hashFunc(symbol));
+    }
+
+    // Same, with hashVal already computed by hashFunc(symbol)
+    bool lookup(string_view symbol, int hashVal)
     {
-        int hashVal = hashFunc(symbol); // Calculate hash value
-        bool b = false;                 // Flag to track if symbol is found
+        STAT(lookups++);
+        unsigned int atom = atoms.find(symbol); // Never-seen spelling cannot be in the table, so
+                                                // a new token returns here without a bucket walk
+        if (atom == AtomTable::NONE)
+        {
+            STAT(examined(0));
+            return false;
+        }
+
+        bool b = false; // Flag to track if symbol is found
+        STAT(examined(table[hashVal].size())); // The whole bucket is always walked
 
         // Search through the bucket at calculated hash index
         for (int j = 0; j < table[hashVal].size(); j++)
         {
-            if (table[hashVal][j].getSymbol() == symbol) // Symbol found
+            STAT(comparisons++);
+            if (table[hashVal][j].getAtom() == atom) // Symbol found
             {
                 fileout << "Found at " << hashVal << "," << j << endl;
                 b = true; // Mark as found
@@ -226,16 +688,19 @@ public:
     }
 
     // Delete a symbol from the symbol table
-    void del(string symbol)
+    void del(string_view symbol)
     {
-        int pos = 0;                    // Position tracker in the bucket
-        int hashVal = hashFunc(symbol); // Calculate hash value
-        bool b = false;                 // Flag to track if symbol is found and deleted
+        int pos = 0;                            // Position tracker in the bucket
+        int hashVal = hashFunc(symbol);         // Calculate hash value
+        unsigned int atom = atoms.find(symbol); // Atom to compare against
+        bool b = false;                         // Flag to track if symbol is found and deleted
+        STAT(deletes++);
 
         // Iterate through the bucket using iterator for safe deletion
         for (auto it = table[hashVal].begin(); it != table[hashVal].end(); it++)
         {
-            if (it->getSymbol() == symbol) // Symbol found
+            STAT(comparisons++);
+            if (atom != AtomTable::NONE && it->getAtom() == atom) // Symbol found
             {
                 fileout << "Deleted from " << hashVal << "," << pos << endl;
                 table[hashVal].erase(it); // Remove symbol
@@ -250,25 +715,56 @@ public:
     }
 
     // Print the entire symbol table for debugging/visualization
+    // Each bucket is formatted into its own line buffer (on several threads
+    // once the table is large), then the lines are written in bucket order
+    // with one write each; the bytes are the same as the old << ... << endl
     void print()
     {
-        // Iterate through all 12 buckets
-        for (int i = 0; i < 12; i++)
+        // Format bucket i into lines[i]
+        auto format = [&](int i)
         {
-            fileout << i << " -> "; // Print bucket index
-            // Print all symbols in current bucket
-            for (int j = 0; j < table[i].size(); j++)
+            string &s = lines[i];
+            s.clear();                                          // Reuse the buffer from the last print
+            char num[12];
+            s.append(num, to_chars(num, num + sizeof num, i).ptr); // Bucket index
+            s += " -> ";
+            for (SymbolInfo &e : table[i]) // All symbols in current bucket
             {
-                fileout << "<" << table[i][j].getSymbol() << ","
-                        << table[i][j].getSymbolType() << "> ";
+                s += '<';
+                s += atoms.view(e.getAtom());
+                s += ',';
+                s += atoms.view(e.getTypeAtom());
+                s += "> ";
             }
-            fileout << endl; // New line after each bucket
+            s += '\n'; // New line after each bucket
+        };
+
+        size_t n = 0; // Symbols in the table
+        for (int i = 0; i < 12; i++)
+            n += table[i].size();
+        size_t threads = min<size_t>({(size_t)thread::hardware_concurrency(), 12, n / PARALLEL_PRINT_SYMBOLS});
+        if (threads < 2) // Small table: format in place
+        {
+            for (int i = 0; i < 12; i++)
+                format(i);
+        }
+        else // Large table: threads take buckets one at a time
+        {
+            atomic<int> next(0);
+            vector<thread> workers;
+            for (size_t t = 0; t < threads; t++)
+                workers.emplace_back([&]() { for (int i; (i = next++) < 12;) format(i); });
+            for (thread &w : workers)
+                w.join();
         }
+        for (int i = 0; i < 12; i++)
+            fileout.write(lines[i].data(), lines[i].size());
+        fileout.flush(); // endl used to flush after every bucket
     }
 
     // Hash function to calculate index for symbol storage
     // Uses sum of first 3 characters multiplied by 2, modulo 12
-    int hashFunc(string symbol)
+    int hashFunc(string_view symbol)
     {
         /*
         // Alternative simpler hash function (commented out)
@@ -289,12 +785,588 @@ public:
     }
 };
 
+// Thread-safe symbol table for lexing several files at once
+// The table is split into 64 independent shards chosen by the top bits of the
+// hash. Each shard has its own bucket array and a reader/writer lock, so
+// lookups on different (or even the same) shard run in parallel and inserts
+// only block the one shard they touch. Names are stored as strings here
+// because the global atom table is single-threaded.
+class ConcurrentSymbolTable
+{
+    struct Entry
+    {
+        unsigned int hash;         // Full hash, checked before the string
+        string symbol, symbolType; // Symbol name and its classification
+    };
+
+    struct Shard
+    {
+        shared_mutex lock;             // Shared for lookups, exclusive for inserts
+        vector<vector<Entry>> buckets; // Chaining, like SymbolTable
+        size_t count = 0;              // Number of symbols in this shard
+
+        Shard() : buckets(16) {}
+
+        // Search the chain of hash h for symbol
+        Entry *find(const string &symbol, unsigned int h)
+        {
+            vector<Entry> &chain = buckets[h & (buckets.size() - 1)];
+            for (Entry &e : chain)
+                if (e.hash == h && e.symbol == symbol)
+                    return &e;
+            return nullptr;
+        }
+
+        // Double the bucket count once chains average more than one entry
+        void grow()
+        {
+            vector<vector<Entry>> old(buckets.size() * 2);
+            old.swap(buckets);
+            for (vector<Entry> &chain : old)
+                for (Entry &e : chain)
+                    buckets[e.hash & (buckets.size() - 1)].push_back(std::move(e));
+        }
+    };
+
+    static const int SHARD_BITS = 6;
+    Shard shards[1 << SHARD_BITS];
+
+    // FNV-1a followed by a final mix so the top bits are usable for sharding
+    static unsigned int hashFunc(const string &symbol)
+    {
+        unsigned int h = 2166136261u;
+        for (unsigned char c : symbol)
+            h = (h ^ c) * 16777619u;
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        return h;
+    }
+
+    Shard &shardOf(unsigned int h)
+    {
+        return shards[h >> (32 - SHARD_BITS)];
+    }
+
+public:
+    // Insert symbol unless it is already present; returns true if it was inserted
+    bool insertIfAbsent(const string &symbol, const string &symbolType)
+    {
+        unsigned int h = hashFunc(symbol);
+        Shard &sh = shardOf(h);
+        {
+            shared_lock<shared_mutex> read(sh.lock); // Common case: already there
+            if (sh.find(symbol, h))
+                return false;
+        }
+        unique_lock<shared_mutex> write(sh.lock);
+        if (sh.find(symbol, h)) // Another thread may have won the race
+            return false;
+        sh.buckets[h & (sh.buckets.size() - 1)].push_back({h, symbol, symbolType});
+        if (++sh.count > sh.buckets.size())
+            sh.grow();
+        return true;
+    }
+
+    // Search for symbol; copies its type into symbolType when found
+    bool lookup(const string &symbol, string *symbolType = nullptr)
+    {
+        unsigned int h = hashFunc(symbol);
+        Shard &sh = shardOf(h);
+        shared_lock<shared_mutex> read(sh.lock);
+        Entry *e = sh.find(symbol, h);
+        if (e && symbolType)
+            *symbolType = e->symbolType;
+        return e != nullptr;
+    }
+
+    // Total number of symbols across all shards
+    size_t size()
+    {
+        size_t n = 0;
+        for (Shard &sh : shards)
+        {
+            shared_lock<shared_mutex> read(sh.lock);
+            n += sh.count;
+        }
+        return n;
+    }
+};
+
+// Tokenize one source buffer into a shared concurrent table
+// Only keywords, identifiers and numbers are collected; this is the part of
+// the main loop that touches the symbol table.
+void lexIntoTable(const string &src, ConcurrentSymbolTable &table)
+{
+    string token;
+    for (size_t i = 0; i <= src.size(); i++)
+    {
+        if (i < src.size() && idOrKey(src[i]))
+        {
+            token += src[i]; // Build token character by character
+            continue;
+        }
+        if (token.empty())
+            continue;
+        if (keyword(token))
+            table.insertIfAbsent(token, "Keyword");
+        else if (id(token))
+            table.insertIfAbsent(token, "Identifier");
+        else if (digit(token))
+            table.insertIfAbsent(token, "Number");
+        token.clear();
+    }
+}
+
+// BENCHMARK - lex an identifier-heavy synthetic source with 1, 2, 4, ... and N threads
+// Each thread gets its own slice of "files" and all of them share one table.
+// Usage: tokenization --bench-concurrent [threads] [files] [lines per file]
+int benchConcurrent(int maxThreads, int files, int linesPerFile)
+{
+    // Build the input: statements over a pool of 50k distinct identifiers
+    mt19937 rng(12345);
+    vector<string> sources(files);
+    for (string &src : sources)
+    {
+        for (int l = 0; l < linesPerFile; l++)
+        {
+            int a = rng() % 50000, b = rng() % 50000, c = rng() % 50000;
+            src += "int v" + to_string(a) + " = v" + to_string(b) + " + count_" + to_string(c) + " * 42;\n";
+        }
+    }
+
+    cout << "threads  seconds  tokens/s      speedup" << endl;
+    double base = 0;
+    // 1, 2, 4, ... threads, then maxThreads itself if it is not a power of two
+    for (int t = 1; t <= maxThreads; t = t < maxThreads && 2 * t > maxThreads ? maxThreads : 2 * t)
+    {
+        ConcurrentSymbolTable table;
+        atomic<int> next(0);
+        auto start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (int w = 0; w < t; w++)
+            workers.emplace_back([&]() {
+                for (int f; (f = next++) < files;)
+                    lexIntoTable(sources[f], table);
+            });
+        for (thread &w : workers)
+            w.join();
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (t == 1)
+            base = sec;
+        double tokens = 5.0 * files * linesPerFile; // Keyword, three names and a number per line
+        cout << setw(7) << t << "  " << fixed << setprecision(3) << setw(7) << sec << "  "
+             << setprecision(0) << setw(12) << tokens / sec << "  "
+             << setprecision(2) << base / sec << "x  (" << table.size() << " symbols)" << endl;
+    }
+    return 0;
+}
+
+// Random insert/lookup/delete mix over 2*symbols names, half of them
+// inserted first; run once with uniform and once with Zipf(0.99) names.
+// Reports throughput and latency percentiles per operation.
+int benchMix(int symbols, int operations, int insertPct, int deletePct)
+{
+    fileout.setstate(ios_base::badbit); // Only the table work is measured
+
+    mt19937_64 rng(42);
+    vector<string> keys = randomIdentifiers(2 * symbols, 42);
+    ZipfDistribution zipf(keys.size(), 0.99);
+    for (int dist = 0; dist < 2; dist++)
+    {
+        SymbolTable table;
+        table.setChangeLog(true); // Skip the full table print after every insert
+        for (size_t i = 0; i < keys.size(); i += 2)
+            table.insertVal(keys[i], "Identifier");
+
+        auto ops = mixOperations(operations, keys.size(), dist ? &zipf : nullptr, insertPct, deletePct, rng);
+        LatencyLog latency;
+        auto start = chrono::steady_clock::now();
+        for (auto &op : ops)
+        {
+            string_view name = keys[op.second];
+            if (op.first == MIX_INSERT)
+                latency.time(op.first, [&] { table.insertVal(name, "Identifier"); });
+            else if (op.first == MIX_LOOKUP)
+                latency.time(op.first, [&] { table.lookup(name); });
+            else
+                latency.time(op.first, [&] { table.del(name); });
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << (dist == 0 ? "uniform" : "zipf(0.99)") << ": " << symbols << " symbols at start, "
+             << operations << " operations in " << fixed << setprecision(3) << seconds << " s ("
+             << setprecision(2) << operations / seconds / 1e6 << " Mops/s)" << endl;
+        latency.print();
+    }
+    return 0;
+}
+
+// The classifiers as they were before the character tables: a fresh
+// vector and a linear find on every call. Only the benchmark uses them,
+// as the baseline and to check the tables give the same answers.
+namespace vectorClassify
+{
+bool op(string ch)
+{
+    vector<string> op = {"+", "-", "*", "%", "&&", "||", "&", "|", "<<", ">>", "=", "+=", "/=",
+                         "%=", "!", "!=", "-=", "==", ">", "<", "!"};
+    return find(op.begin(), op.end(), ch) != op.end();
+}
+
+bool punc(char ch)
+{
+    vector<char> punc = {',', '.', ';', '?', ':'};
+    return find(punc.begin(), punc.end(), ch) != punc.end();
+}
+
+bool keyword(string a)
+{
+    vector<string> key = {"if", "else", "else if", "for", "while", "do", "break", "int", "void",
+                          "char", "float", "double", "unsigned", "const", "return", "include"};
+    return find(key.begin(), key.end(), a) != key.end();
+}
+
+bool interrupt(char ch)
+{
+    vector<char> bracket = {'(', ')', '{', '}', '[', ']', ',', '.', ';', '?', ':'};
+    return find(bracket.begin(), bracket.end(), ch) != bracket.end();
+}
+} // namespace vectorClassify
+
+// Classify every byte of src the way the main loop did before the operator
+// DFA: interrupt and space for each non-identifier character, op for the
+// character and the pair it starts, keyword for each finished word. Returns a checksum so
+// the work cannot be optimized away.
+template <class Op, class Keyword, class Interrupt>
+long long classifySource(const string &src, Op isOp, Keyword isKeyword, Interrupt isInterrupt)
+{
+    long long sum = 0;
+    size_t wordStart = 0;
+    for (size_t i = 0; i < src.size(); i++)
+    {
+        if (idOrKey(src[i]))
+            continue; // Still inside a word
+        if (i > wordStart)
+            sum += isKeyword(src.substr(wordStart, i - wordStart));
+        wordStart = i + 1;
+        if (!isInterrupt(src[i]) && !space(src[i]))
+        {
+            string temp(1, src[i]);
+            if (isOp(temp))
+                sum += 2 + isOp(temp + src[i + 1]);
+        }
+        else
+            sum += isInterrupt(src[i]);
+    }
+    return sum;
+}
+
+// BENCHMARK - per-byte cost of character classification
+// Runs the table classifiers and the old vector ones over the same
+// generated source, after checking they agree on every byte and pair.
+// Usage: tokenization --bench-classify [MiB]
+int benchClassify(int mib)
+{
+    for (int a = 0; a < 256; a++)
+    {
+        char c = a;
+        if (punc(c) != vectorClassify::punc(c) || interrupt(c) != vectorClassify::interrupt(c))
+        {
+            cerr << "character tables disagree on byte " << a << endl;
+            return 1;
+        }
+        for (int b = 0; b < 256; b++)
+        {
+            string pair = {c, (char)b};
+            if (op(string(1, c)) != vectorClassify::op(string(1, c)) || op(pair) != vectorClassify::op(pair))
+            {
+                cerr << "operator table disagrees on bytes " << a << " " << b << endl;
+                return 1;
+            }
+        }
+    }
+    for (string_view k : KEYWORDS)
+        if (!keyword(k))
+            return 1;
+
+    // Source with the usual mix of keywords, names, operators and brackets
+    mt19937 rng(2024);
+    const char *types[] = {"int", "float", "double", "char", "unsigned"};
+    const char *ops[] = {"+", "-", "*", "%", "<<", ">>", "&&", "||", "==", "!="};
+    string src;
+    while (src.size() < (size_t)mib << 20)
+    {
+        string a = "v" + to_string(rng() % 5000), b = "count_" + to_string(rng() % 5000);
+        src += string(types[rng() % 5]) + " " + a + " = " + b + " " + ops[rng() % 10] + " " +
+               to_string(rng() % 1000) + ";\n";
+        if (rng() % 4 == 0)
+            src += "if (" + a + " < " + b + ") { return " + a + "; }\n";
+        if (rng() % 4 == 0)
+            src += "while (" + b + " != 0) " + b + " -= 1;\n";
+    }
+
+    auto run = [&](const char *label, auto isOp, auto isKeyword, auto isInterrupt) {
+        auto start = chrono::steady_clock::now();
+        long long sum = classifySource(src, isOp, isKeyword, isInterrupt);
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << label << fixed << setprecision(2) << 1e9 * sec / src.size() << " ns/byte  "
+             << setprecision(1) << src.size() / sec / 1e6 << " MB/s  (checksum " << sum << ")" << endl;
+        return sec;
+    };
+
+    cout << "classifying " << src.size() << " bytes" << endl;
+    double vectorSec = run("vector + find: ", [](string s) { return vectorClassify::op(s); },
+                           [](string s) { return vectorClassify::keyword(s); },
+                           [](char c) { return vectorClassify::interrupt(c); });
+    double tableSec = run("char tables:   ", [](const string &s) { return op(s); },
+                          [](const string &s) { return keyword(s); }, [](char c) { return interrupt(c); });
+    cout << "speedup: " << setprecision(2) << vectorSec / tableSec << "x" << endl;
+    return 0;
+}
+
+// Tokenize a whole file through MappedFile and Scanner (--mmap)
+// Writes the same per-kind files as the line-by-line loop in main, with
+// the tokens taken straight from the mapping, and inserts into the symbol
+// table in the same order: that loop classifies a word only when the
+// character after it arrives, so an operator written right after a word
+// goes in before the word. Errors are reported where that loop reports
+// them (a malformed word followed by a bracket or punctuation), with the
+// column added. Differences from that loop: literals and comments may
+// span lines, comments are skipped, and a word at the end of a line is
+// still classified.
+// Returns false if the file cannot be read.
+bool tokenizeMapped(const char *path, SymbolTable &ob, ostream &key, ostream &func, ostream &identifier,
+                    ostream &operat, ostream &num, ostream &liter)
+{
+    MappedFile source(path);
+    if (!source.ok())
+        return false;
+
+    Scanner scanner(source.text());
+
+    // TOKEN CLASSIFICATION - the word branch of the main loop
+    auto classify = [&](const Token &w) {
+        char next = scanner.after(w); // Character that ended the word
+        if (keyword(w.text))          // Check if token is a keyword
+        {
+            key << w.text << " " << w.line << "\n";
+            ob.insertVal(w.text, "Keyword");
+        }
+        else if (id(w.text)) // FUNCTION vs IDENTIFIER - a '(' right after the name
+        {
+            (next == '(' ? func : identifier) << w.text << " " << w.line << "\n";
+            ob.insertVal(w.text, next == '(' ? "Function" : "Identifier");
+        }
+        else if (digit(w.text)) // Check if token is a number
+        {
+            num << w.text << " " << w.line << "\n";
+            ob.insertVal(w.text, "Number");
+        }
+        else if (interrupt(next)) // Starts with a digit but is not a number, e.g. 12abc
+            cout << "Lexical error at line " << w.line << ", column " << w.column
+                 << " and error is: " << w.text << endl;
+    };
+
+    Token t, word;        // Current token and the word waiting to be classified
+    bool pending = false; // Whether word is waiting
+    while (scanner.next(t))
+    {
+        // Only an operator that touches the word is handled before it
+        bool touching = pending && t.kind == OPERATOR && t.text.data() == word.text.data() + word.text.size();
+        if (pending && !touching)
+        {
+            classify(word);
+            pending = false;
+        }
+
+        if (t.kind == WORD)
+        {
+            word = t;
+            pending = true;
+        }
+        else if (t.kind == OPERATOR)
+        {
+            operat << t.text << " " << t.line << "\n";
+            ob.insertVal(t.text, "Operator");
+        }
+        else if (t.kind == LITERAL)
+            liter << t.text << " " << t.line << "\n";
+
+        if (touching)
+        {
+            classify(word);
+            pending = false;
+        }
+    }
+    if (pending) // Word at the very end of the file
+        classify(word);
+    return true;
+}
+
+// BENCHMARK - getline + token += s[i] against the zero-copy Scanner
+// Both only split a generated source into words, operators and literals
+// and count them; the symbol table is left out. Built with
+// -DCOUNT_ALLOCATIONS it also reports the heap allocations of each pass.
+// Usage: tokenization --bench-mmap [MiB]
+int benchMapped(int mib)
+{
+    const char *path = "bench_source.txt"; // Written once, removed at the end
+    {
+        mt19937 rng(99);
+        ofstream out(path, ios::binary);
+        long long size = 0;
+        while (size < (long long)mib << 20)
+        {
+            string a = "value_" + to_string(rng() % 5000), b = "counter_" + to_string(rng() % 5000);
+            string stmt = "int " + a + " = " + b + " << 2 + " + to_string(rng() % 1000) + ";\n";
+            if (rng() % 4 == 0)
+                stmt += "if (" + a + " >= 1) printf(\"" + b + " %d\\n\", " + a + ");\n";
+            out << stmt;
+            size += stmt.size();
+        }
+    }
+
+    // Line by line, building each token by appending, as main does
+    auto byLine = [&]() {
+        ifstream in(path);
+        string s;
+        long long tokens = 0;
+        while (getline(in, s))
+        {
+            string token = "", lit = "";
+            bool literal = false;
+            for (size_t i = 0; i < s.size(); i++)
+            {
+                if (s[i] == '"')
+                {
+                    if (literal)
+                    {
+                        lit += s[i];
+                        tokens++;
+                    }
+                    else
+                        lit = s[i];
+                    literal = !literal;
+                    continue;
+                }
+                if (literal)
+                {
+                    lit += s[i];
+                    continue;
+                }
+                if (idOrKey(s[i]))
+                {
+                    token += s[i];
+                    continue;
+                }
+                if (!interrupt(s[i]) && !space(s[i]))
+                {
+                    string temp(1, s[i]);
+                    if (size_t len = longestOperator(s, i))
+                    {
+                        temp = s.substr(i, len);
+                        i += len - 1;
+                        tokens++;
+                    }
+                }
+                tokens += !token.empty();
+                token = "";
+            }
+            tokens += !token.empty();
+        }
+        return tokens;
+    };
+
+    // Whole file mapped, tokens are views into it
+    auto mapped = [&]() {
+        MappedFile source(path);
+        Scanner scanner(source.text());
+        Token t;
+        long long tokens = 0;
+        while (scanner.next(t))
+            tokens += t.kind != SEPARATOR;
+        return tokens;
+    };
+
+    auto run = [&](const char *label, auto pass) {
+#ifdef COUNT_ALLOCATIONS
+        long long before = allocationCount;
+#endif
+        auto start = chrono::steady_clock::now();
+        long long tokens = pass();
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << label << tokens << " tokens in " << fixed << setprecision(3) << sec << " s  ("
+             << setprecision(1) << tokens / sec / 1e6 << " M tokens/s)";
+#ifdef COUNT_ALLOCATIONS
+        cout << "  " << allocationCount - before << " allocations";
+#endif
+        cout << endl;
+        return sec;
+    };
+
+    double lineSec = run("getline + append: ", byLine);
+    double mapSec = run("mmap + views:     ", mapped);
+    cout << "speedup: " << setprecision(2) << lineSec / mapSec << "x" << endl;
+    remove(path);
+    return 0;
+}
+
 // MAIN FUNCTION - Entry point of the lexical analyzer
-int main()
+int main(int argc, char *argv[])
 {
+    // Benchmark mode for the concurrent table
+    if (argc > 1 && string(argv[1]) == "--bench-concurrent")
+    {
+        int threads = argc > 2 ? atoi(argv[2]) : (int)max(1u, thread::hardware_concurrency());
+        int files = argc > 3 ? atoi(argv[3]) : 64;
+        int lines = argc > 4 ? atoi(argv[4]) : 2000;
+        return benchConcurrent(threads, files, lines);
+    }
+    // Mixed workload benchmark: --bench-mix [symbols] [operations] [insert%/lookup%/delete%]
+    if (argc > 1 && string(argv[1]) == "--bench-mix")
+    {
+        int symbols = argc > 2 ? atoi(argv[2]) : 10000;
+        int operations = argc > 3 ? atoi(argv[3]) : 200000;
+        int insertPct = 10, lookupPct = 80, deletePct = 10;
+        if (argc > 4 && (sscanf(argv[4], "%d/%d/%d", &insertPct, &lookupPct, &deletePct) != 3 ||
+                         insertPct + lookupPct + deletePct != 100))
+        {
+            cerr << "The mix must be three percentages adding up to 100, e.g. 10/80/10." << endl;
+            return 1;
+        }
+        if (symbols < 1 || operations < 1)
+        {
+            cerr << "The benchmark needs at least one symbol and one operation." << endl;
+            return 1;
+        }
+        return benchMix(symbols, operations, insertPct, deletePct);
+    }
+    // Character classification benchmark: --bench-classify [MiB of source]
+    if (argc > 1 && string(argv[1]) == "--bench-classify")
+        return benchClassify(argc > 2 ? atoi(argv[2]) : 8);
+    // Line-by-line against memory-mapped tokenizing: --bench-mmap [MiB of source]
+    if (argc > 1 && string(argv[1]) == "--bench-mmap")
+        return benchMapped(argc > 2 ? atoi(argv[2]) : 32);
+
     string symbol, symbolType; // Variables for symbol processing
     SymbolTable ob;            // Create symbol table object
 
+    // Output mode flags:
+    //   --log-changes  write only inserted entries to output.txt
+    //   --final-dump   print the whole table once after tokenizing
+    //   --mmap         map the whole input and tokenize it without copying
+    bool finalDump = false, useMmap = false;
+    for (int a = 1; a < argc; a++)
+    {
+        if (string(argv[a]) == "--log-changes")
+            ob.setChangeLog(true);
+        else if (string(argv[a]) == "--final-dump")
+            finalDump = true;
+        else if (string(argv[a]) == "--mmap")
+            useMmap = true;
+    }
+
     // File handles for input and different types of output
     ifstream input;                        // Input file stream
     ofstream key("output1_keyword.txt");   // Keywords output
@@ -304,7 +1376,13 @@ int main()
     ofstream num("output1_number.txt");    // Numbers output
     ofstream liter("output1_literal.txt"); // String literals output
 
-    input.open("sample_input2.txt"); // Open source code file for reading
+    if (useMmap) // Zero-copy path; input stays closed, so the loop below does nothing
+    {
+        if (!tokenizeMapped("sample_input2.txt", ob, key, func, identifier, operat, num, liter))
+            cout << "Cannot open sample_input2.txt" << endl;
+    }
+    else
+        input.open("sample_input2.txt"); // Open source code file for reading
 
     string s = ""; // String to store each line from input file
     int line = 1;  // Line number counter for error reporting
@@ -364,22 +1442,14 @@ int main()
                 // OPERATOR HANDLING - Process non-identifier characters
                 if (!interrupt(s[i]) && !space(s[i]))
                 {
-                    temp = s[i];  // Store current character
-                    if (op(temp)) // Check if it's a valid operator
+                    temp = s[i];                        // Store current character
+                    size_t len = longestOperator(s, i); // Longest operator starting here (<<=, ==, <, ...)
+                    if (len)                            // Check if it's a valid operator
                     {
-                        // Check for two-character operators (==, <=, ++, etc.)
-                        string y = temp + s[i + 1]; // Combine with next character
-                        if (op(y))                  // Two-character operator found
-                        {
-                            operat << y << " " << line << endl; // Write to operators file
-                            i++;                                // Skip next character (already processed)
-                            ob.insertVal(y, "Operator");        // Add to symbol table
-                        }
-                        else // Single-character operator
-                        {
-                            operat << temp << " " << line << endl; // Write to operators file
-                            ob.insertVal(temp, "Operator");        // Add to symbol table
-                        }
+                        string_view oper(s.data() + i, len);
+                        operat << oper << " " << line << endl; // Write to operators file
+                        ob.insertVal(oper, "Operator");        // Add to symbol table
+                        i += len - 1;                          // Skip the rest of the operator (already processed)
                         op_pattern = true;
                     }
                     else
@@ -443,5 +1513,11 @@ int main()
 
     input.close(); // Close input file
 
+    if (finalDump) // Single dump of the final table
+    {
+        fileout << "Final table:" << endl;
+        ob.print();
+    }
+
     return 0; // Program executed successfully
 }